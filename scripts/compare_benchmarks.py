@@ -0,0 +1,201 @@
+import json
+import os
+import random
+import argparse
+import statistics
+import subprocess
+import sys
+import tempfile
+
+TIME_SCALE = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+# Fewer samples per side than this get no confidence interval.
+MIN_SAMPLES = 3
+
+def split_contender(full_name, index=0):
+    """
+    Splits a benchmark name into its contender (template argument `index`)
+    and the case it ran, with the contender replaced by '*':
+    BM_RandomAccess<absl::flat_hash_map<int, int>, LookupMode::kDependent>/1024
+      -> ('absl::flat_hash_map<int, int>', 'BM_RandomAccess<*, LookupMode::kDependent>/1024')
+    """
+    start = full_name.find('<')
+    if start < 0:
+        return None, None
+    args = []
+    depth = 0
+    arg_start = start + 1
+    for i in range(start, len(full_name)):
+        c = full_name[i]
+        if c == '<':
+            depth += 1
+        elif c == '>':
+            depth -= 1
+            if depth == 0:
+                args.append((arg_start, i))
+                break
+        elif c == ',' and depth == 1:
+            args.append((arg_start, i))
+            arg_start = i + 1
+    if depth != 0 or index >= len(args):
+        return None, None
+    a, b = args[index]
+    while a < b and full_name[a] == ' ':
+        a += 1
+    return full_name[a:b], full_name[:a] + '*' + full_name[b:]
+
+def load_samples(json_files, metric, contender_arg):
+    """
+    Per-repetition times in ns, as {case: {contender: [times]}}. Aggregates
+    (mean, median, ...) are skipped; every repetition is one sample.
+    """
+    samples = {}
+    for json_file in json_files:
+        with open(json_file, 'r') as f:
+            data = json.load(f)
+        for bm in data.get('benchmarks', []):
+            if bm.get('run_type') == 'aggregate' or 'error_occurred' in bm:
+                continue
+            contender, case = split_contender(bm.get('run_name', bm['name']), contender_arg)
+            if contender is None:
+                continue
+            time_ns = bm[metric] * TIME_SCALE.get(bm.get('time_unit', 'ns'), 1.0)
+            samples.setdefault(case, {}).setdefault(contender, []).append(time_ns)
+    return samples
+
+def mad(values):
+    """Median absolute deviation from the median."""
+    center = statistics.median(values)
+    return statistics.median(abs(v - center) for v in values)
+
+def bootstrap_ratio_ci(values, baseline, rng, resamples, confidence):
+    """
+    Percentile bootstrap confidence interval of median(values) / median(baseline),
+    resampling both sides independently.
+    """
+    ratios = sorted(
+        statistics.median(rng.choices(values, k=len(values))) /
+        statistics.median(rng.choices(baseline, k=len(baseline)))
+        for _ in range(resamples))
+    tail = (1.0 - confidence) / 2.0
+    lo = ratios[int(tail * (resamples - 1))]
+    hi = ratios[int((1.0 - tail) * (resamples - 1))]
+    return lo, hi
+
+def format_time(ns):
+    for unit, scale in (('s', 1e9), ('ms', 1e6), ('us', 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3g} {unit}"
+    return f"{ns:.3g} ns"
+
+def describe_ratio(ratio, lo, hi):
+    if lo <= 1.0 <= hi:
+        return "n.s."
+    return f"{ratio:.2f}x slower" if ratio > 1.0 else f"{1.0 / ratio:.2f}x faster"
+
+def run_benchmarks(executable, extra_args, benchmark_filter, repetitions, processes):
+    """
+    Runs `executable` `processes` times. Each run repeats every benchmark
+    `repetitions` times with Google Benchmark's random interleaving, so the
+    contenders alternate in a different random order instead of running
+    one after another.
+    """
+    json_files = []
+    for p in range(processes):
+        fd, path = tempfile.mkstemp(prefix='compare_', suffix='.json')
+        os.close(fd)
+        command = [executable, *extra_args,
+                   f'--benchmark_repetitions={repetitions}',
+                   '--benchmark_enable_random_interleaving=true',
+                   f'--benchmark_out={path}', '--benchmark_out_format=json']
+        if benchmark_filter:
+            command.append(f'--benchmark_filter={benchmark_filter}')
+        print(f"[{p + 1}/{processes}] {' '.join(command)}", file=sys.stderr)
+        subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+        json_files.append(path)
+    return json_files
+
+def compare(samples, baseline, confidence, resamples, seed, markdown):
+    rng = random.Random(seed)
+    rows = []
+    for case in sorted(samples):
+        contenders = samples[case]
+        base = [c for c in contenders if baseline in c]
+        if len(base) != 1:
+            print(f"Skipping {case}: {len(base)} contenders match baseline '{baseline}'.", file=sys.stderr)
+            continue
+        base_values = contenders[base[0]]
+        for contender, values in sorted(contenders.items(), key=lambda item: statistics.median(item[1])):
+            median = statistics.median(values)
+            spread = mad(values) / median if median else 0.0
+            if contender == base[0]:
+                rows.append((case, contender, len(values), median, spread, 1.0, None, "baseline"))
+                continue
+            ratio = median / statistics.median(base_values)
+            if min(len(values), len(base_values)) < MIN_SAMPLES:
+                rows.append((case, contender, len(values), median, spread, ratio, None, "too few samples"))
+                continue
+            lo, hi = bootstrap_ratio_ci(values, base_values, rng, resamples, confidence)
+            rows.append((case, contender, len(values), median, spread, ratio, (lo, hi), describe_ratio(ratio, lo, hi)))
+
+    if not rows:
+        print("Nothing to compare.")
+        return
+
+    level = f"{confidence * 100:g}% CI"
+    if markdown:
+        print(f"| Case | Contender | n | Median | MAD | Ratio | {level} | Verdict |")
+        print("| :--- | :--- | ---: | ---: | ---: | ---: | :--- | :--- |")
+        for case, contender, n, median, spread, ratio, ci, verdict in rows:
+            interval = f"[{ci[0]:.3f}, {ci[1]:.3f}]" if ci else ""
+            print(f"| `{case}` | `{contender}` | {n} | {format_time(median)} | {spread * 100:.1f}% | "
+                  f"{ratio:.3f} | {interval} | {verdict} |")
+        return
+
+    current = None
+    for case, contender, n, median, spread, ratio, ci, verdict in rows:
+        if case != current:
+            print(f"\n{case}")
+            print(f"  {'contender':<40} {'n':>4} {'median':>10} {'MAD':>7} {'ratio':>7}  {level:<18} verdict")
+            current = case
+        interval = f"[{ci[0]:.3f}, {ci[1]:.3f}]" if ci else ""
+        print(f"  {contender:<40} {n:>4} {format_time(median):>10} {spread * 100:>6.1f}% {ratio:>7.3f}  "
+              f"{interval:<18} {verdict}")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Compare contenders from interleaved, repeated benchmark runs: median, MAD and "
+                    "bootstrap confidence intervals of each contender's time relative to a baseline. "
+                    "Extra arguments are passed to the benchmark executable.")
+    parser.add_argument("json_files", nargs='*', help="Existing JSON results (with repetitions) to analyze")
+    parser.add_argument("--run", metavar="EXECUTABLE", help="Benchmark executable to run instead of reading JSON files")
+    parser.add_argument("-f", "--filter", help="--benchmark_filter for --run")
+    parser.add_argument("-r", "--repetitions", type=int, default=10, help="Repetitions per process (default 10)")
+    parser.add_argument("-p", "--processes", type=int, default=3,
+                        help="Separate processes to run, each interleaved differently (default 3)")
+    parser.add_argument("-b", "--baseline", required=True, help="Substring identifying the baseline contender")
+    parser.add_argument("--contender-arg", type=int, default=0,
+                        help="Which template argument of the benchmark name is the contender (default 0)")
+    parser.add_argument("--metric", choices=['real_time', 'cpu_time'], default='real_time')
+    parser.add_argument("--confidence", type=float, default=0.95, help="Confidence level (default 0.95)")
+    parser.add_argument("--bootstrap", type=int, default=2000, help="Bootstrap resamples (default 2000)")
+    parser.add_argument("--seed", type=int, default=1, help="Bootstrap seed")
+    parser.add_argument("--markdown", action="store_true", help="Print a Markdown table")
+
+    args, extra_args = parser.parse_known_args()
+
+    json_files = list(args.json_files)
+    temporary = []
+    if args.run:
+        temporary = run_benchmarks(args.run, extra_args, args.filter, args.repetitions, args.processes)
+        json_files += temporary
+    elif extra_args:
+        parser.error(f"unrecognized arguments: {' '.join(extra_args)}")
+    if not json_files:
+        parser.error("give JSON files or --run EXECUTABLE")
+
+    try:
+        compare(load_samples(json_files, args.metric, args.contender_arg),
+                args.baseline, args.confidence, args.bootstrap, args.seed, args.markdown)
+    finally:
+        for path in temporary:
+            os.remove(path)
@@ -0,0 +1,72 @@
+import json
+import math
+import os
+import argparse
+import statistics
+
+SUFFIX = '/interference'
+
+def quiet_name(full_name):
+    # BM_HistogramSort<absl::flat_hash_map<int, int>>/interference/N:256/distinct:16
+    #   -> BM_HistogramSort<absl::flat_hash_map<int, int>>/N:256/distinct:16
+    family, sep, rest = full_name.partition('/')
+    if rest == SUFFIX[1:] or rest.startswith(SUFFIX[1:] + '/'):
+        return family + rest[len(SUFFIX) - 1:], True
+    return full_name, False
+
+def load_times(json_file):
+    """
+    Median real time per benchmark run, in ns, split into quiet and
+    interference runs keyed by the quiet name.
+    """
+    with open(json_file, 'r') as f:
+        data = json.load(f)
+    scale = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    samples = {}
+    for bm in data.get('benchmarks', []):
+        if bm.get('run_type') == 'aggregate' or 'error_occurred' in bm:
+            continue
+        name, noisy = quiet_name(bm.get('run_name', bm['name']))
+        time_ns = bm['real_time'] * scale.get(bm.get('time_unit', 'ns'), 1.0)
+        samples.setdefault((name, noisy), []).append(time_ns)
+    return {key: statistics.median(times) for key, times in samples.items()}
+
+def geomean(values):
+    return math.exp(sum(math.log(v) for v in values) / len(values))
+
+def report(json_file, verbose):
+    if not os.path.exists(json_file):
+        print(f"File {json_file} not found. Skipping.")
+        return
+
+    times = load_times(json_file)
+    # Contender = everything before the arguments, e.g. BM_RandomAccess<absl::flat_hash_map<int, int>, LookupMode::kDependent>
+    slowdowns = {}
+    for (name, noisy), noisy_time in times.items():
+        if not noisy or (name, False) not in times:
+            continue
+        slowdown = noisy_time / times[(name, False)]
+        slowdowns.setdefault(name.split('/')[0], []).append((name, slowdown))
+
+    if not slowdowns:
+        print(f"No quiet/interference pairs found in {json_file}. Run the suite with --interference=SPEC.")
+        return
+
+    width = max(len(contender) for contender in slowdowns)
+    print(f"{'contender':<{width}}  {'pairs':>5}  {'geomean':>8}  {'min':>6}  {'max':>6}")
+    for contender, pairs in sorted(slowdowns.items()):
+        values = [s for _, s in pairs]
+        print(f"{contender:<{width}}  {len(values):>5}  {geomean(values):>7.2f}x  {min(values):>5.2f}x  {max(values):>5.2f}x")
+        if verbose:
+            for name, slowdown in sorted(pairs):
+                print(f"    {name}  {slowdown:.2f}x")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Report each contender's slowdown under --interference from benchmark JSON output.")
+    parser.add_argument("json_file", help="Path to the JSON benchmark results file")
+    parser.add_argument("-v", "--verbose", action="store_true", help="Also print the slowdown of every argument set")
+
+    args = parser.parse_args()
+
+    report(args.json_file, args.verbose)
@@ -8,10 +8,20 @@ import numpy as np
 def parse_benchmark_name(full_name):
     # Regex to extract Map Type and Size
     # Example: BM_HistogramSort<std::unordered_map<int, int>>/256
+    # Extra arguments become part of the series name, so
+    # BM_HistogramSort<absl::flat_hash_map<int, int>>/N:256/distinct:16
+    # is plotted as the series "absl::flat_hash_map distinct:16" at size 256.
     match = re.search(r'<(.+)>/(.+)', full_name)
     if match:
         map_type = match.group(1).replace('<int, int>', '') # Clean up for legend
-        size = int(match.group(2))
+        args = match.group(2).split('/')
+        try:
+            size = int(args[0].split(':')[-1])
+        except ValueError:
+            return None, None
+        extra = [a for a in args[1:] if not a.startswith(('threads:', 'repeats:', 'min_time:'))]
+        if extra:
+            map_type = f"{map_type} {' '.join(extra)}"
         return map_type, size
     return None, None
 
@@ -67,7 +77,7 @@ def format_time(ns):
     else:
         return f"{ns:.2f} ns"
 
-def plot_benchmark(json_file, title=None, output_file=None):
+def plot_benchmark(json_file, title=None, output_file=None, xlabel='Input Size (N)'):
     if not os.path.exists(json_file):
         print(f"File {json_file} not found. Skipping.")
         return
@@ -175,7 +185,7 @@ def plot_benchmark(json_file, title=None, output_file=None):
     # For log-log plot, log(n) is a curve that flattens out.
     
     ax.set_title(title, fontsize=16)
-    ax.set_xlabel('Input Size (N)', fontsize=12)
+    ax.set_xlabel(xlabel, fontsize=12)
     ax.set_ylabel('Time (ns)', fontsize=12)
     # ax.set_xscale('log')
     # ax.set_yscale('log')
@@ -196,7 +206,9 @@ if __name__ == "__main__":
     parser.add_argument("json_file", help="Path to the JSON benchmark results file")
     parser.add_argument("-o", "--output", help="Path to output PNG file (optional)")
     parser.add_argument("-t", "--title", help="Chart title (optional)")
+    parser.add_argument("-x", "--xlabel", default="Input Size (N)",
+                        help="X axis label, e.g. 'Table Footprint (bytes)' for random_access_benchmarks")
     
     args = parser.parse_args()
     
-    plot_benchmark(args.json_file, args.title, args.output)
+    plot_benchmark(args.json_file, args.title, args.output, args.xlabel)
@@ -0,0 +1,94 @@
+import json
+import matplotlib.pyplot as plt
+import re
+import os
+import argparse
+
+def parse_load_factor_name(full_name):
+    # Example: BM_LoadFactorLookupHit<absl::flat_hash_map<int, int>>/N:16384/load_pct:50
+    match = re.search(r'^(BM_\w+)<(.+)>/N:(\d+)/load_pct:(\d+)', full_name)
+    if match:
+        bench = match.group(1)
+        map_type = match.group(2).replace('<int, int>', '') # Clean up for legend
+        return bench, map_type, int(match.group(3))
+    return None, None, None
+
+def pareto_front(points):
+    """
+    Returns the points not dominated by any other point
+    (no other point is both smaller in memory and faster).
+    """
+    front = []
+    best_time = float('inf')
+    for x, y in sorted(points):
+        if y < best_time:
+            front.append((x, y))
+            best_time = y
+    return front
+
+def plot_pareto(json_file, bench_name, size, output_file=None):
+    if not os.path.exists(json_file):
+        print(f"File {json_file} not found. Skipping.")
+        return
+
+    with open(json_file, 'r') as f:
+        try:
+            data = json.load(f)
+        except json.JSONDecodeError:
+            print(f"Error decoding JSON from {json_file}. File might be empty or invalid.")
+            return
+
+    results = {}
+    for bm in data.get('benchmarks', []):
+        bench, map_type, n = parse_load_factor_name(bm['name'])
+        if bench != bench_name or n != size or 'bytes_per_entry' not in bm:
+            continue
+        # Time per item: insert benchmarks process many keys per iteration.
+        time_per_item = 1e9 / bm['items_per_second'] if bm.get('items_per_second') else bm['real_time']
+        results.setdefault(map_type, []).append((bm['bytes_per_entry'], time_per_item, bm.get('load_factor', 0)))
+
+    if not results:
+        print(f"No {bench_name} results with N={size} found in {json_file}.")
+        return
+
+    if not output_file:
+        base_name = os.path.splitext(os.path.basename(json_file))[0]
+        output_file = os.path.join(os.path.dirname(json_file), f"{base_name}_{bench_name}_{size}_pareto.png")
+
+    fig, ax = plt.subplots(figsize=(12, 8))
+    markers = ['o', 's', '^', 'D', 'v', '<', '>']
+
+    for i, (map_type, points) in enumerate(results.items()):
+        points.sort()
+        xs = [p[0] for p in points]
+        ys = [p[1] for p in points]
+        line, = ax.plot(xs, ys, marker=markers[i % len(markers)], linestyle=':', alpha=0.6, label=map_type)
+        front = pareto_front([(p[0], p[1]) for p in points])
+        ax.plot([p[0] for p in front], [p[1] for p in front], color=line.get_color(), linewidth=2)
+
+        # Annotate each point with the achieved load factor
+        for x, y, lf in points:
+            ax.annotate(f"{lf:.2f}", (x, y), textcoords="offset points", xytext=(0, 5), ha='center', fontsize=9)
+
+    ax.set_title(f"{bench_name} (N={size}): time vs memory", fontsize=16)
+    ax.set_xlabel('Bytes per Entry', fontsize=12)
+    ax.set_ylabel('Time per Item (ns)', fontsize=12)
+    ax.grid(True, which="both", ls="-", alpha=0.5)
+    ax.legend(fontsize=10, loc='best')
+    plt.tight_layout()
+
+    plt.savefig(output_file)
+    print(f"Saved plot to {output_file}")
+    plt.close()
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Plot speed vs memory Pareto curves from load_factor_benchmarks JSON output.")
+    parser.add_argument("json_file", help="Path to the JSON benchmark results file")
+    parser.add_argument("-b", "--benchmark", default="BM_LoadFactorLookupHit",
+                        help="Benchmark to plot (BM_LoadFactorInsert, BM_LoadFactorLookupHit, BM_LoadFactorLookupMiss)")
+    parser.add_argument("-n", "--size", type=int, default=1 << 20, help="Base size N to plot")
+    parser.add_argument("-o", "--output", help="Path to output PNG file (optional)")
+
+    args = parser.parse_args()
+
+    plot_pareto(args.json_file, args.benchmark, args.size, args.output)
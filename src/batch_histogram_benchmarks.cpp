@@ -0,0 +1,166 @@
+/**
+ * @file batch_histogram_benchmarks.cpp
+ * @brief Millions of small histograms on a worker pool: work stealing vs static vs mutex queue.
+ *
+ * A batch is 1M groups of ints with log-normal sizes (median 4, sigma 1.5):
+ * about a hundred groups exceed 1K values and the largest has a few thousand
+ * (kMaxGroupSize only clamps, it is never reached). Every group is
+ * histogram-sorted on its own (counted in a map, then written back grouped
+ * by key, as histogramSort does), using one map per worker that is cleared
+ * and reused from group to group.
+ *
+ * Groups are handed out in tasks of 16 consecutive groups by one of the
+ * task sources of batch_scheduler.h: StaticPartition, MutexQueue or
+ * WorkStealingDeques. Argument `layout` sets the group order:
+ * - 0: shuffled, so every contiguous block gets a similar mix of sizes.
+ * - 1: sorted by size, largest first (data clustered by tenant or key),
+ *      so the first worker's static block holds most of the work.
+ *
+ * Reports values/sec (items_per_second), `groups_per_second`, `imbalance`
+ * (slowest worker's busy time over the mean, 1 = perfectly balanced) and
+ * `steals` per batch.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <thread>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "batch_scheduler.h"
+
+// Groups per batch.
+static constexpr size_t kGroups = size_t{1} << 20;
+// Consecutive groups per task.
+static constexpr size_t kGroupsPerTask = 16;
+// Largest group.
+static constexpr size_t kMaxGroupSize = size_t{1} << 16;
+
+/**
+ * @brief All groups' values back to back: group g is values[offsets[g], offsets[g + 1]).
+ */
+struct Batch {
+    std::vector<uint32_t> offsets{0};
+    std::vector<int> values;
+
+    size_t groups() const { return offsets.size() - 1; }
+};
+
+/**
+ * @brief A batch of kGroups groups in order @p layout (see file comment).
+ *
+ * A group of n values draws them from [0, n), so about 2/3 of them are distinct.
+ */
+static Batch MakeBatch(int layout) {
+    std::mt19937 gen(42);
+    std::lognormal_distribution<double> size_dis(std::log(4.0), 1.5);
+    std::vector<uint32_t> sizes(kGroups);
+    for (uint32_t& size : sizes) {
+        size = static_cast<uint32_t>(std::clamp<double>(std::ceil(size_dis(gen)), 1.0, kMaxGroupSize));
+    }
+    if (layout == 1) std::sort(sizes.begin(), sizes.end(), std::greater<>());
+
+    Batch batch;
+    for (uint32_t size : sizes) {
+        std::uniform_int_distribution<int> value_dis(0, static_cast<int>(size) - 1);
+        for (uint32_t i = 0; i < size; ++i) batch.values.push_back(value_dis(gen));
+        batch.offsets.push_back(static_cast<uint32_t>(batch.values.size()));
+    }
+    return batch;
+}
+
+/**
+ * @brief Histogram sort of one group into @p out, reusing @p counts.
+ */
+template<typename Hashmap>
+static void HistogramGroup(Hashmap& counts, const int* values, size_t n, int* out) {
+    counts.clear();
+    for (size_t i = 0; i < n; ++i) counts[values[i]]++;
+    for (const auto& [key, count] : counts) {
+        for (int j = 0; j < count; ++j) *out++ = key;
+    }
+}
+
+/**
+ * @brief One batch per iteration on a pool of range(0) workers.
+ * Arguments: range(0) = workers, range(1) = layout.
+ */
+template<typename Hashmap, typename TaskSource>
+static void BM_BatchHistogram(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    const size_t workers = state.range(0);
+    const Batch batch = MakeBatch(static_cast<int>(state.range(1)));
+    const size_t num_tasks = (batch.groups() + kGroupsPerTask - 1) / kGroupsPerTask;
+    std::vector<int> out(batch.values.size());
+
+    struct alignas(64) Worker {
+        Hashmap counts;
+        double busy_seconds = 0;
+    };
+    std::vector<Worker> per_worker(workers);
+    WorkerPool pool(workers);
+    TaskSource tasks;
+
+    double imbalance = 0;
+    size_t steals = 0;
+    for (auto _ : state) {
+        tasks.reset(num_tasks, workers);
+        const Clock::time_point start = Clock::now();
+        pool.run([&](size_t w) {
+            Worker& worker = per_worker[w];
+            uint32_t task;
+            while (tasks.next(w, task)) {
+                const size_t end = std::min(batch.groups(), (task + 1) * kGroupsPerTask);
+                for (size_t g = task * kGroupsPerTask; g < end; ++g) {
+                    const uint32_t begin = batch.offsets[g];
+                    HistogramGroup(worker.counts, batch.values.data() + begin, batch.offsets[g + 1] - begin,
+                                   out.data() + begin);
+                }
+            }
+            worker.busy_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        });
+        benchmark::DoNotOptimize(out.data());
+
+        double slowest = 0, total = 0;
+        for (const Worker& worker : per_worker) {
+            slowest = std::max(slowest, worker.busy_seconds);
+            total += worker.busy_seconds;
+        }
+        imbalance += total > 0 ? slowest / (total / workers) : 1.0;
+        steals += tasks.steals();
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch.values.size());
+    state.counters["groups_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * batch.groups()), benchmark::Counter::kIsRate);
+    state.counters["imbalance"] = imbalance / state.iterations();
+    state.counters["steals"] = static_cast<double>(steals) / state.iterations();
+}
+
+/**
+ * @brief 1, 2, 4, ... workers up to the hardware thread count, for both layouts.
+ */
+static void BatchArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"workers", "layout"});
+    const int64_t max_workers = std::max(1u, std::thread::hardware_concurrency());
+    for (int64_t layout : {0, 1}) {
+        for (int64_t workers = 1; workers < max_workers; workers *= 2) bench->Args({workers, layout});
+        bench->Args({max_workers, layout});
+    }
+    bench->UseRealTime();
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_BatchHistogram, absl::flat_hash_map<int, int>, StaticPartition)->Apply(BatchArgs);
+BENCHMARK_TEMPLATE(BM_BatchHistogram, absl::flat_hash_map<int, int>, MutexQueue)->Apply(BatchArgs);
+BENCHMARK_TEMPLATE(BM_BatchHistogram, absl::flat_hash_map<int, int>, WorkStealingDeques)->Apply(BatchArgs);
+BENCHMARK_TEMPLATE(BM_BatchHistogram, std::unordered_map<int, int>, StaticPartition)->Apply(BatchArgs);
+BENCHMARK_TEMPLATE(BM_BatchHistogram, std::unordered_map<int, int>, MutexQueue)->Apply(BatchArgs);
+BENCHMARK_TEMPLATE(BM_BatchHistogram, std::unordered_map<int, int>, WorkStealingDeques)->Apply(BatchArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,226 @@
+/**
+ * @file batch_scheduler.h
+ * @brief A worker pool and three ways to hand a batch of tasks to its workers.
+ *
+ * A batch is the task ids [0, n). WorkerPool::run() starts one job per
+ * worker; each job pulls task ids from a task source until it is drained:
+ *
+ *     WorkerPool pool(4);
+ *     WorkStealingDeques tasks;
+ *     tasks.reset(num_tasks, pool.size());
+ *     pool.run([&](size_t worker) {
+ *         uint32_t task;
+ *         while (tasks.next(worker, task)) Process(worker, task);
+ *     });
+ *
+ * Task sources:
+ * - StaticPartition: worker w owns the contiguous block [w*n/W, (w+1)*n/W).
+ *   No synchronization at all, no balancing either.
+ * - MutexQueue: one shared cursor behind one mutex.
+ * - WorkStealingDeques: every worker starts with its StaticPartition block in
+ *   its own deque and pops from the back; a worker whose deque is empty
+ *   steals from the front of the others'.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of threads that run one job per worker at a time.
+ *
+ * Worker 0 is the calling thread, so a pool of 1 runs jobs inline.
+ */
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t workers) : workers_(std::max<size_t>(workers, 1)) {
+        for (size_t w = 1; w < workers_; ++w) {
+            threads_.emplace_back([this, w] { loop(w); });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (std::thread& thread : threads_) thread.join();
+    }
+
+    size_t size() const { return workers_; }
+
+    /**
+     * @brief Runs @p job(w) for every worker w and returns when all have finished.
+     */
+    void run(std::function<void(size_t)> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = std::move(job);
+            pending_ = workers_ - 1;
+            ++generation_;
+        }
+        start_.notify_all();
+        job_(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    void loop(size_t worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            job_(worker);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    size_t workers_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    std::function<void(size_t)> job_;
+    uint64_t generation_ = 0;
+    size_t pending_ = 0;
+    bool stop_ = false;
+};
+
+/**
+ * @brief First task id of worker @p worker's block when @p num_tasks are split over @p workers.
+ */
+inline uint32_t BlockBegin(size_t num_tasks, size_t workers, size_t worker) {
+    return static_cast<uint32_t>(num_tasks * worker / workers);
+}
+
+/**
+ * @brief Each worker runs its own contiguous block of tasks, nothing else.
+ */
+class StaticPartition {
+public:
+    void reset(size_t num_tasks, size_t workers) {
+        blocks_.assign(workers, Block{});
+        for (size_t w = 0; w < workers; ++w) {
+            blocks_[w].next = BlockBegin(num_tasks, workers, w);
+            blocks_[w].end = BlockBegin(num_tasks, workers, w + 1);
+        }
+    }
+
+    bool next(size_t worker, uint32_t& task) {
+        Block& block = blocks_[worker];
+        if (block.next == block.end) return false;
+        task = block.next++;
+        return true;
+    }
+
+    size_t steals() const { return 0; }
+
+private:
+    struct alignas(64) Block {
+        uint32_t next = 0;
+        uint32_t end = 0;
+    };
+    std::vector<Block> blocks_;
+};
+
+/**
+ * @brief All workers take the next task from one shared, mutex-protected cursor.
+ */
+class MutexQueue {
+public:
+    void reset(size_t num_tasks, size_t /*workers*/) {
+        next_ = 0;
+        end_ = static_cast<uint32_t>(num_tasks);
+    }
+
+    bool next(size_t /*worker*/, uint32_t& task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (next_ == end_) return false;
+        task = next_++;
+        return true;
+    }
+
+    size_t steals() const { return 0; }
+
+private:
+    std::mutex mutex_;
+    uint32_t next_ = 0;
+    uint32_t end_ = 0;
+};
+
+/**
+ * @brief Per-worker deques; idle workers steal from the other end of a victim's deque.
+ *
+ * Owners pop from the back and thieves take from the front, so an owner and
+ * a thief only meet on a deque's last task. Victims are tried in order
+ * starting after the thief, so idle workers spread over different victims.
+ * Tasks are never added during a batch, so a worker that finds every deque
+ * empty is done.
+ */
+class WorkStealingDeques {
+public:
+    void reset(size_t num_tasks, size_t workers) {
+        if (deques_.size() != workers) deques_ = std::vector<Deque>(workers);
+        for (size_t w = 0; w < workers; ++w) {
+            std::lock_guard<std::mutex> lock(deques_[w].mutex);
+            deques_[w].tasks.clear();
+            for (uint32_t t = BlockBegin(num_tasks, workers, w); t < BlockBegin(num_tasks, workers, w + 1); ++t) {
+                deques_[w].tasks.push_back(t);
+            }
+        }
+        steals_.store(0, std::memory_order_relaxed);
+    }
+
+    bool next(size_t worker, uint32_t& task) {
+        {
+            Deque& own = deques_[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < deques_.size(); ++i) {
+            Deque& victim = deques_[(worker + i) % deques_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Tasks taken from another worker's deque since the last reset().
+    size_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Deque {
+        std::mutex mutex;
+        std::deque<uint32_t> tasks;
+    };
+    std::vector<Deque> deques_;
+    std::atomic<size_t> steals_{0};
+};
@@ -0,0 +1,176 @@
+/**
+ * @file benchmark_data.h
+ * @brief Input generators shared by the benchmark suites.
+ *
+ * All generators use fixed seeds, so every contender and every run sees the
+ * same keys in the same order.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Generates a vector of integers in ascending order.
+ * @param size Number of elements to generate.
+ * @return std::vector<int> Vector containing [0, 1, ..., size-1].
+ */
+inline std::vector<int> GenerateAscendingData(size_t size) {
+    std::vector<int> data(size);
+    std::iota(data.begin(), data.end(), 0);
+    return data;
+}
+
+/**
+ * @brief Generates a vector of integers in descending order.
+ * @param size Number of elements to generate.
+ * @return std::vector<int> Vector containing [size-1, size-2, ..., 0].
+ */
+inline std::vector<int> GenerateDescendingData(size_t size) {
+    std::vector<int> data(size);
+    std::iota(data.rbegin(), data.rend(),0);
+    return data;
+}
+
+/**
+ * @brief Generates a vector of random integers.
+ * Uses a fixed seed (42) for reproducible benchmark results.
+ * @param size Number of elements to generate.
+ * @return std::vector<int> Vector containing random integers between 0 and size.
+ */
+inline std::vector<int> GenerateRandomData(size_t size) {
+    std::vector<int> data(size);
+    std::mt19937 gen(42); // Fixed seed for reproducibility
+    std::uniform_int_distribution<> dis(0, static_cast<int>(size));
+    for (auto& val : data) {
+        val = dis(gen);
+    }
+    return data;
+}
+
+/**
+ * @brief Generates a vector of random integers spread over twice the range.
+ * Uses a fixed seed (42). Drawing from [0, 2 * size] keeps about 79% of the
+ * values distinct (BM_RandomAccess tables), against about 63% for GenerateRandomData(size).
+ * @param size Number of elements to generate.
+ * @return std::vector<int> Vector containing random integers between 0 and 2 * size.
+ */
+inline std::vector<int> GenerateSpreadRandomData(size_t size) {
+    std::vector<int> data(size);
+    std::mt19937 gen(42); // Fixed seed for reproducibility
+    std::uniform_int_distribution<> dis(0, static_cast<int>(size) * 2);
+    for (auto& val : data) {
+        val = dis(gen);
+    }
+    return data;
+}
+
+/**
+ * @brief Generates random integers with a controlled number of distinct keys.
+ *
+ * The distinct keys are a random subset of [0, size], so key magnitudes match
+ * GenerateRandomData(). Every key appears at least once; the remaining
+ * positions are drawn uniformly from the same keys. Uses a fixed seed (42).
+ *
+ * @param size Number of elements to generate.
+ * @param distinct Number of distinct keys, clamped to [1, size].
+ * @return std::vector<int> Vector with exactly `distinct` different values.
+ */
+inline std::vector<int> GenerateRandomData(size_t size, size_t distinct) {
+    distinct = std::clamp<size_t>(distinct, 1, size);
+    std::mt19937 gen(42); // Fixed seed for reproducibility
+
+    std::vector<int> keys(size + 1);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    keys.resize(distinct);
+
+    std::vector<int> data(size);
+    std::copy(keys.begin(), keys.end(), data.begin());
+    std::uniform_int_distribution<size_t> dis(0, distinct - 1);
+    for (size_t i = distinct; i < size; ++i) {
+        data[i] = keys[dis(gen)];
+    }
+    std::shuffle(data.begin(), data.end(), gen);
+    return data;
+}
+
+/**
+ * @brief Generates distinct random even keys; `key | 1` is then guaranteed absent.
+ * @param count Number of keys to generate.
+ * @param seed Seed for the generator (fixed for reproducibility).
+ */
+inline std::vector<int> GenerateDistinctEvenKeys(size_t count, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dis(0, (1 << 30) - 1);
+    std::vector<int> keys;
+    while (keys.size() < count) {
+        while (keys.size() < count + count / 8) keys.push_back(dis(gen) * 2);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+    std::shuffle(keys.begin(), keys.end(), gen);
+    keys.resize(count);
+    return keys;
+}
+
+/**
+ * @brief Draws ranks in [0, n) from a Zipf distribution, P(rank r) ~ 1 / (r + 1)^theta.
+ *
+ * theta = 0 is uniform; theta around 1 is the classic heavy skew of real
+ * key frequencies. Sampling inverts a precomputed CDF, so setup is O(n)
+ * and every draw is a binary search.
+ */
+class ZipfGenerator {
+public:
+    ZipfGenerator(size_t n, double theta, uint32_t seed) : cdf_(std::max<size_t>(n, 1)), gen_(seed) {
+        double sum = 0;
+        for (size_t r = 0; r < cdf_.size(); ++r) {
+            sum += 1.0 / std::pow(static_cast<double>(r + 1), theta);
+            cdf_[r] = sum;
+        }
+        for (double& p : cdf_) p /= sum;
+    }
+
+    size_t operator()() {
+        const double u = uniform_(gen_);
+        const size_t r = std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin();
+        return std::min(r, cdf_.size() - 1);
+    }
+
+private:
+    std::vector<double> cdf_;
+    std::mt19937_64 gen_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+};
+
+/**
+ * @brief Like GenerateRandomData(size, distinct), but key frequencies follow Zipf(theta).
+ *
+ * The distinct keys are the same random subset of [0, size]; the most
+ * frequent key is the first of that subset. Rare keys may not appear at all.
+ *
+ * @param size Number of elements to generate.
+ * @param distinct Number of candidate keys, clamped to [1, size].
+ * @param theta Zipf exponent; 0 is uniform.
+ */
+inline std::vector<int> GenerateZipfData(size_t size, size_t distinct, double theta) {
+    distinct = std::clamp<size_t>(distinct, 1, size);
+    std::mt19937 gen(42); // Fixed seed for reproducibility
+
+    std::vector<int> keys(size + 1);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    keys.resize(distinct);
+
+    ZipfGenerator zipf(distinct, theta, 42);
+    std::vector<int> data(size);
+    for (int& val : data) val = keys[zipf()];
+    return data;
+}
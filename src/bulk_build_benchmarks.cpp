@@ -0,0 +1,133 @@
+/**
+ * @file bulk_build_benchmarks.cpp
+ * @brief Building a read-only table from N keys: serial inserts vs parallel bulk builds.
+ *
+ * Startup of a service that loads static lookup tables is dominated by
+ * building them. Every benchmark builds a table of N distinct keys (value =
+ * key) from scratch per iteration; destruction is not timed.
+ * - BM_SerialBuild<Hashmap>: reserve, then N `map[key] = value` on one thread,
+ *   as BM_RandomAccess does.
+ * - BM_ParallelBuild<Builder> on `threads` workers:
+ *   - StaticTableBuilder: StaticHashTable::build (static_hash_table.h), which
+ *     partitions the keys by hash prefix and fills disjoint slot ranges.
+ *   - PhmapSubmapBuilder: phmap::parallel_flat_hash_map with 64 submaps and
+ *     no mutex; every worker scans all keys and inserts the ones whose
+ *     submap index belongs to it, the lock-free pattern phmap documents.
+ *
+ * Reports keys/sec (items_per_second, real time).
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "batch_scheduler.h"
+#include "static_hash_table.h"
+#include "benchmark_data.h"
+
+/**
+ * @brief N serial inserts into a reserved map. Argument: range(0) = N.
+ */
+template<typename Hashmap>
+static void BM_SerialBuild(benchmark::State& state) {
+    const std::vector<int> keys = GenerateDistinctEvenKeys(state.range(0), 42);
+    const std::vector<int>& values = keys;
+
+    for (auto _ : state) {
+        {
+            Hashmap map;
+            map.reserve(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) map[keys[i]] = values[i];
+            benchmark::DoNotOptimize(map);
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/**
+ * @brief StaticHashTable built in one call on the pool.
+ */
+struct StaticTableBuilder {
+    using Table = StaticHashTable<int, int>;
+
+    static void Build(Table& table, const std::vector<int>& keys, const std::vector<int>& values, WorkerPool& pool) {
+        table.build(keys, values, pool);
+    }
+};
+
+/**
+ * @brief phmap's parallel map filled by submap ownership, without locks.
+ */
+struct PhmapSubmapBuilder {
+    using Table = phmap::parallel_flat_hash_map<int, int, phmap::priv::hash_default_hash<int>,
+                                                phmap::priv::hash_default_eq<int>,
+                                                std::allocator<std::pair<const int, int>>, 6, phmap::NullMutex>;
+
+    static void Build(Table& table, const std::vector<int>& keys, const std::vector<int>& values, WorkerPool& pool) {
+        table.reserve(keys.size());
+        const size_t workers = pool.size();
+        pool.run([&](size_t w) {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                const size_t hash = table.hash(keys[i]);
+                if (table.subidx(hash) % workers == w) table.emplace_with_hash(hash, keys[i], values[i]);
+            }
+        });
+    }
+};
+
+/**
+ * @brief One bulk build per iteration. Arguments: range(0) = N, range(1) = threads.
+ */
+template<typename Builder>
+static void BM_ParallelBuild(benchmark::State& state) {
+    const std::vector<int> keys = GenerateDistinctEvenKeys(state.range(0), 42);
+    const std::vector<int>& values = keys;
+    WorkerPool pool(state.range(1));
+
+    for (auto _ : state) {
+        {
+            typename Builder::Table table;
+            Builder::Build(table, keys, values, pool);
+            benchmark::DoNotOptimize(table);
+            state.PauseTiming();
+            if (table.size() != keys.size()) state.SkipWithError("table is missing keys");
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void SerialArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("N")->Arg(1 << 20)->Arg(1 << 24)->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+/**
+ * @brief 1M and 16M keys on 1, 2, 4, ... workers up to the hardware thread count.
+ */
+static void ParallelArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "threads"});
+    const int64_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int64_t n : {int64_t{1} << 20, int64_t{1} << 24}) {
+        for (int64_t threads = 1; threads < max_threads; threads *= 2) bench->Args({n, threads});
+        bench->Args({n, max_threads});
+    }
+    bench->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_SerialBuild, std::unordered_map<int, int>)->Apply(SerialArgs);
+BENCHMARK_TEMPLATE(BM_SerialBuild, absl::flat_hash_map<int, int>)->Apply(SerialArgs);
+BENCHMARK_TEMPLATE(BM_SerialBuild, robin_hood::unordered_map<int, int>)->Apply(SerialArgs);
+BENCHMARK_TEMPLATE(BM_SerialBuild, phmap::flat_hash_map<int, int>)->Apply(SerialArgs);
+
+BENCHMARK_TEMPLATE(BM_ParallelBuild, StaticTableBuilder)->Apply(ParallelArgs);
+BENCHMARK_TEMPLATE(BM_ParallelBuild, PhmapSubmapBuilder)->Apply(ParallelArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,177 @@
+/**
+ * @file cache_info.h
+ * @brief Detection of the data cache hierarchy and cache-aware size sweeps.
+ *
+ * Cache sizes are read from sysfs on Linux and from CPUID on x86 elsewhere.
+ * If neither source answers, typical desktop sizes are assumed so the
+ * benchmarks still get a sensible sweep.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+/**
+ * @brief One data (or unified) cache level.
+ */
+struct CacheLevel {
+    int level;          ///< 1 for L1, 2 for L2, ...
+    size_t size_bytes;  ///< Capacity as seen by one core.
+};
+
+/**
+ * @brief Parses sysfs size strings such as "48K", "2048K" or "32M".
+ * @return Size in bytes, 0 if the string is malformed.
+ */
+inline size_t ParseCacheSize(const std::string& text) {
+    size_t pos = 0;
+    size_t value = 0;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+        value = value * 10 + static_cast<size_t>(text[pos] - '0');
+        ++pos;
+    }
+    if (pos == 0) return 0;
+    if (pos < text.size()) {
+        switch (text[pos]) {
+            case 'K': value <<= 10; break;
+            case 'M': value <<= 20; break;
+            case 'G': value <<= 30; break;
+            default: break;
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Reads the caches of cpu0 from /sys/devices/system/cpu/cpu0/cache.
+ * @return Data and unified caches, empty if sysfs is not available.
+ */
+inline std::vector<CacheLevel> ReadCachesFromSysfs() {
+    std::vector<CacheLevel> caches;
+    for (int index = 0; index < 16; ++index) {
+        const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream level_file(dir + "level");
+        std::ifstream type_file(dir + "type");
+        std::ifstream size_file(dir + "size");
+        if (!level_file || !type_file || !size_file) break;
+
+        int level = 0;
+        std::string type, size;
+        level_file >> level;
+        type_file >> type;
+        size_file >> size;
+        if (type == "Instruction") continue;
+
+        const size_t bytes = ParseCacheSize(size);
+        if (level > 0 && bytes > 0) caches.push_back({level, bytes});
+    }
+    return caches;
+}
+
+/**
+ * @brief Reads the caches with the deterministic cache parameters leaf
+ *        (CPUID 4 on Intel, 0x8000001D on AMD).
+ * @return Data and unified caches, empty on non-x86 targets.
+ */
+inline std::vector<CacheLevel> ReadCachesFromCpuid() {
+    std::vector<CacheLevel> caches;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)) || defined(__x86_64__) || defined(__i386__)
+    auto cpuid = [](unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+        int out[4];
+        __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(out[i]);
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    };
+
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    const unsigned max_leaf = regs[0];
+    cpuid(0x80000000u, 0, regs);
+    const unsigned max_ext_leaf = regs[0];
+
+    for (unsigned leaf : {4u, 0x8000001Du}) {
+        if ((leaf < 0x80000000u && leaf > max_leaf) || (leaf >= 0x80000000u && leaf > max_ext_leaf)) continue;
+        for (unsigned subleaf = 0; subleaf < 16; ++subleaf) {
+            cpuid(leaf, subleaf, regs);
+            const unsigned type = regs[0] & 0x1F;  // 0 = no more caches, 2 = instruction
+            if (type == 0) break;
+            if (type == 2) continue;
+            const int level = static_cast<int>((regs[0] >> 5) & 0x7);
+            const size_t ways = ((regs[1] >> 22) & 0x3FF) + 1;
+            const size_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+            const size_t line = (regs[1] & 0xFFF) + 1;
+            const size_t sets = static_cast<size_t>(regs[2]) + 1;
+            caches.push_back({level, ways * partitions * line * sets});
+        }
+        if (!caches.empty()) break;
+    }
+#endif
+    return caches;
+}
+
+/**
+ * @brief Detects the data cache hierarchy, sorted from L1 outwards.
+ */
+inline std::vector<CacheLevel> DetectDataCaches() {
+    std::vector<CacheLevel> caches = ReadCachesFromSysfs();
+    if (caches.empty()) caches = ReadCachesFromCpuid();
+    if (caches.empty()) {
+        caches = {{1, size_t{32} << 10}, {2, size_t{1} << 20}, {3, size_t{32} << 20}};
+    }
+    std::sort(caches.begin(), caches.end(),
+              [](const CacheLevel& a, const CacheLevel& b) { return a.level < b.level; });
+    return caches;
+}
+
+/**
+ * @brief Names the innermost cache level a working set of @p bytes fits in.
+ * @return "L1", "L2", ... or "DRAM" if it exceeds the last level cache.
+ */
+inline std::string CacheLevelFor(size_t bytes, const std::vector<CacheLevel>& caches) {
+    for (const CacheLevel& cache : caches) {
+        if (bytes <= cache.size_bytes) return "L" + std::to_string(cache.level);
+    }
+    return "DRAM";
+}
+
+/**
+ * @brief Generates working-set sizes (in bytes) that are dense around every
+ *        cache boundary and sparse in between.
+ *
+ * Each boundary B contributes points from B/2 to 2B, so the cliff where a
+ * table stops fitting in a level is sampled on both sides.
+ *
+ * @param caches Cache hierarchy from DetectDataCaches().
+ * @param max_bytes Upper bound for the largest point (keeps DRAM points affordable).
+ */
+inline std::vector<size_t> CacheAwareSizes(const std::vector<CacheLevel>& caches, size_t max_bytes) {
+    static constexpr double kFactors[] = {0.5, 0.625, 0.75, 0.875, 1.0, 1.125, 1.25, 1.5, 2.0};
+
+    std::vector<size_t> sizes;
+    sizes.push_back(caches.front().size_bytes / 4);
+    for (const CacheLevel& cache : caches) {
+        for (double factor : kFactors) {
+            sizes.push_back(static_cast<size_t>(cache.size_bytes * factor));
+        }
+    }
+    // Well past the last level cache, where every lookup goes to memory.
+    sizes.push_back(caches.back().size_bytes * 4);
+
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    sizes.erase(std::remove_if(sizes.begin(), sizes.end(), [&](size_t s) { return s > max_bytes; }), sizes.end());
+    return sizes;
+}
@@ -0,0 +1,254 @@
+/**
+ * @file compact_counter_map.h
+ * @brief Counting hash map with small inline counters and an overflow side table.
+ *
+ * Histogram counts are mostly tiny, yet a `<int, int>` map spends 4 bytes
+ * on every count (plus padding and metadata in the flat maps). This map
+ * stores keys and 8- or 16-bit saturating counters in cache-line sized
+ * buckets:
+ *
+ *     | key 0 | ... | key S-1 | cnt 0 | ... | cnt S-1 | used |   (64 bytes)
+ *
+ * With `int` keys a bucket holds 12 entries for 8-bit counters and 10 for
+ * 16-bit counters, versus 8 `std::pair<int, int>` slots per line in a flat
+ * map. Slots of a bucket fill front to back (there is no erase), so a
+ * single fill count replaces per-slot control bytes. Once a counter
+ * saturates, further increments of that key go to a side table holding
+ * the excess count.
+ *
+ * Supported operations are the ones histogram counting needs: increment,
+ * read, iterate.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+
+template<typename Key, typename Counter = uint8_t, typename Hash = absl::Hash<Key>>
+class CompactCounterMap {
+    static_assert(std::is_unsigned_v<Counter>, "counters must be unsigned");
+
+public:
+    using key_type = Key;
+    using mapped_type = int64_t;
+    using value_type = std::pair<Key, int64_t>;
+    using size_type = size_t;
+
+    static constexpr Counter kSaturated = std::numeric_limits<Counter>::max();
+
+private:
+    static constexpr size_t kLineBytes = 64;
+    // One byte of every line is reserved for the fill count.
+    static constexpr size_t kSlots = (kLineBytes - 1) / (sizeof(Key) + sizeof(Counter));
+    static_assert(kSlots >= 1 && kSlots <= 31, "key type too wide for a cache-line bucket");
+
+    struct alignas(kLineBytes) Bucket {
+        Key keys[kSlots];
+        Counter counts[kSlots];
+        uint8_t used;  // slots [0, used) are occupied
+    };
+    static_assert(sizeof(Bucket) == kLineBytes, "a bucket must fill exactly one cache line");
+
+public:
+    /**
+     * @brief Proxy returned by operator[]; increments go straight to the table.
+     *
+     * Unlike std::unordered_map, reading `map[key]` does not insert the key.
+     * Post-increment returns nothing so `map[key]++` costs a single probe.
+     */
+    class CounterRef {
+    public:
+        CounterRef(CompactCounterMap& map, const Key& key) : map_(map), key_(key) {}
+        CounterRef& operator++() { map_.increment(key_); return *this; }
+        void operator++(int) { map_.increment(key_); }
+        CounterRef& operator+=(int64_t n) { map_.increment(key_, n); return *this; }
+        operator int64_t() const { return map_.count(key_); }
+
+    private:
+        CompactCounterMap& map_;
+        Key key_;
+    };
+
+    /**
+     * @brief Forward iterator yielding (key, total count) pairs by value.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CompactCounterMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+        const_iterator(const CompactCounterMap* map, size_t bucket) : map_(map), bucket_(bucket) { settle(); }
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+        const_iterator& operator++() { ++slot_; settle(); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& other) const { return bucket_ == other.bucket_ && slot_ == other.slot_; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        // Skips exhausted buckets and caches the pair the iterator points at.
+        void settle() {
+            while (bucket_ < map_->num_buckets_) {
+                const Bucket& bucket = map_->buckets_[bucket_];
+                if (slot_ < bucket.used) {
+                    current_ = {bucket.keys[slot_], map_->total(bucket.keys[slot_], bucket.counts[slot_])};
+                    return;
+                }
+                ++bucket_;
+                slot_ = 0;
+            }
+        }
+
+        const CompactCounterMap* map_ = nullptr;
+        size_t bucket_ = 0;
+        size_t slot_ = 0;
+        value_type current_{};
+    };
+    using iterator = const_iterator;
+
+    CompactCounterMap() = default;
+    CompactCounterMap(CompactCounterMap&&) noexcept = default;
+    CompactCounterMap& operator=(CompactCounterMap&&) noexcept = default;
+
+    CounterRef operator[](const Key& key) { return CounterRef(*this, key); }
+
+    /**
+     * @brief Adds @p n occurrences of @p key, inserting it if needed.
+     */
+    void increment(const Key& key, int64_t n = 1) {
+        if ((size_ + 1) * kMaxLoadDen > num_buckets_ * kSlots * kMaxLoadNum) {
+            rehash(num_buckets_ ? num_buckets_ * 2 : 1);
+        }
+        for (size_t b = hash_(key) & mask_;; b = (b + 1) & mask_) {
+            Bucket& bucket = buckets_[b];
+            if (const uint32_t found = match(bucket, key)) {
+                add(bucket.counts[std::countr_zero(found)], key, n);
+                return;
+            }
+            if (bucket.used < kSlots) {
+                const size_t i = bucket.used++;
+                bucket.keys[i] = key;
+                bucket.counts[i] = 0;
+                ++size_;
+                add(bucket.counts[i], key, n);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Total number of occurrences of @p key (0 if absent).
+     */
+    int64_t count(const Key& key) const {
+        if (size_ == 0) return 0;
+        for (size_t b = hash_(key) & mask_;; b = (b + 1) & mask_) {
+            const Bucket& bucket = buckets_[b];
+            if (const uint32_t found = match(bucket, key)) {
+                return total(key, bucket.counts[std::countr_zero(found)]);
+            }
+            if (bucket.used < kSlots) return 0;
+        }
+    }
+
+    /**
+     * @brief Makes room for @p n distinct keys without rehashing.
+     */
+    void reserve(size_t n) {
+        size_t buckets = 1;
+        while (buckets * kSlots * kMaxLoadNum < n * kMaxLoadDen) buckets *= 2;
+        if (buckets > num_buckets_) rehash(buckets);
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, num_buckets_); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    /// Number of slots (buckets times entries per bucket).
+    size_t bucket_count() const { return num_buckets_ * kSlots; }
+    /// Keys whose counter saturated and spilled into the side table.
+    size_t overflow_count() const { return overflow_.size(); }
+    /// Heap bytes of the bucket array (the side table is not included).
+    size_t allocated_bytes() const { return num_buckets_ * sizeof(Bucket); }
+
+private:
+    // Maximum load: 7/8 of all slots. Buckets absorb collisions, so this
+    // rarely spills into the next bucket.
+    static constexpr size_t kMaxLoadNum = 7;
+    static constexpr size_t kMaxLoadDen = 8;
+
+    // Bit i set: occupied slot i holds `key`. Compares every slot without
+    // early exit, so the loop has no data-dependent branches and vectorizes.
+    static uint32_t match(const Bucket& bucket, const Key& key) {
+        uint32_t found = 0;
+        for (size_t i = 0; i < kSlots; ++i) {
+            found |= static_cast<uint32_t>(bucket.keys[i] == key) << i;
+        }
+        return found & ((uint32_t{1} << bucket.used) - 1);
+    }
+
+    void add(Counter& counter, const Key& key, int64_t n) {
+        const int64_t room = kSaturated - counter;
+        if (n <= room) {
+            counter = static_cast<Counter>(counter + n);
+        } else {
+            counter = kSaturated;
+            overflow_[key] += n - room;
+        }
+    }
+
+    int64_t total(const Key& key, Counter counter) const {
+        if (counter != kSaturated) return counter;
+        auto it = overflow_.find(key);
+        return kSaturated + (it == overflow_.end() ? 0 : it->second);
+    }
+
+    void rehash(size_t new_buckets) {
+        std::unique_ptr<Bucket[]> old = std::move(buckets_);
+        const size_t old_buckets = num_buckets_;
+
+        buckets_ = std::make_unique<Bucket[]>(new_buckets);  // value-initialized: all buckets empty
+        num_buckets_ = new_buckets;
+        mask_ = new_buckets - 1;
+
+        // Counters move as they are; the side table is keyed by key and stays valid.
+        for (size_t b = 0; b < old_buckets; ++b) {
+            for (size_t i = 0; i < old[b].used; ++i) {
+                place(old[b].keys[i], old[b].counts[i]);
+            }
+        }
+    }
+
+    void place(const Key& key, Counter counter) {
+        for (size_t b = hash_(key) & mask_;; b = (b + 1) & mask_) {
+            Bucket& bucket = buckets_[b];
+            if (bucket.used < kSlots) {
+                const size_t i = bucket.used++;
+                bucket.keys[i] = key;
+                bucket.counts[i] = counter;
+                return;
+            }
+        }
+    }
+
+    std::unique_ptr<Bucket[]> buckets_;
+    size_t num_buckets_ = 0;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    Hash hash_;
+    absl::flat_hash_map<Key, int64_t, Hash> overflow_;  ///< Excess count of saturated keys.
+};
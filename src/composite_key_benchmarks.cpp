@@ -0,0 +1,170 @@
+/**
+ * @file composite_key_benchmarks.cpp
+ * @brief Contenders keyed by composite and wide keys (composite_keys.h).
+ *
+ * Every map runs with four key types (TenantId = pair<int, int>,
+ * TenantShardId = tuple<int, int, int>, Key16, Key32) and two hashers:
+ * - the contender's default: absl::Hash / phmap::Hash, which combine fields
+ *   natively (Key16/Key32 through their AbslHashValue / hash_value), and
+ *   CombineHash for std and robin_hood, which have none.
+ * - BytesHash: a lane-parallel hash over the raw key bytes.
+ *
+ * Benchmarks cover building a map of N keys and independent lookups of
+ * present and absent keys. Absent keys differ from present ones only in
+ * the low bit of the id field, so a hash that mixes some fields poorly
+ * shows up as extra collisions.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "composite_keys.h"
+#include "benchmark_data.h"
+#include "memory_usage.h"
+
+template<typename Key, template<typename> class Hash = CombineHash>
+using StdMap = std::unordered_map<Key, uint32_t, Hash<Key>>;
+template<typename Key, template<typename> class Hash = absl::Hash>
+using AbslMap = absl::flat_hash_map<Key, uint32_t, Hash<Key>>;
+template<typename Key, template<typename> class Hash = CombineHash>
+using RobinMap = robin_hood::unordered_map<Key, uint32_t, Hash<Key>>;
+template<typename Key, template<typename> class Hash = phmap::Hash>
+using PhmapMap = phmap::flat_hash_map<Key, uint32_t, Hash<Key>>;
+
+/// splitmix64, used to fill the bytes of wide keys from a seed.
+static uint64_t SplitMix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Key whose id field is @p id; the other fields are derived from it.
+ *
+ * Keys built from distinct ids are distinct, and so are keys whose ids differ
+ * only in the low bit, which is how absent keys are made.
+ */
+template<typename Key>
+static Key MakeKey(int id) {
+    const uint64_t base = static_cast<uint64_t>(id >> 1);
+    if constexpr (std::is_same_v<Key, TenantId>) {
+        return {static_cast<int>(base % 64), id};
+    } else if constexpr (std::is_same_v<Key, TenantShardId>) {
+        return {static_cast<int>(base % 64), static_cast<int>(SplitMix(base) % 1024), id};
+    } else {
+        Key key;
+        constexpr size_t kWords = sizeof(key.words) / sizeof(key.words[0]);
+        for (size_t i = 0; i + 1 < kWords; ++i) key.words[i] = SplitMix(base + i);
+        key.words[kWords - 1] = static_cast<uint64_t>(id);
+        return key;
+    }
+}
+
+/**
+ * @brief N distinct present keys in random order, and N absent ones.
+ */
+template<typename Key>
+struct KeySet {
+    std::vector<Key> present;
+    std::vector<Key> absent;
+
+    explicit KeySet(size_t n) {
+        for (int id : GenerateDistinctEvenKeys(n, 42)) {
+            present.push_back(MakeKey<Key>(id));
+            absent.push_back(MakeKey<Key>(id | 1));
+        }
+    }
+};
+
+/**
+ * @brief Builds a map of N keys from empty. Argument: range(0) = N.
+ */
+template<typename Hashmap>
+static void BM_CompositeInsert(benchmark::State& state) {
+    using Key = typename Hashmap::key_type;
+    const KeySet<Key> keys(state.range(0));
+
+    for (auto _ : state) {
+        Hashmap map;
+        for (uint32_t i = 0; i < keys.present.size(); ++i) map[keys.present[i]] = i;
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.present.size());
+
+    Hashmap map;
+    const size_t bytes = BuildAndMeasure(map, [&] {
+        for (uint32_t i = 0; i < keys.present.size(); ++i) map[keys.present[i]] = i;
+    });
+    state.counters["key_bytes"] = sizeof(Key);
+    state.counters["bytes_per_entry"] = static_cast<double>(bytes) / map.size();
+}
+
+/**
+ * @brief Independent lookups of present (Hit) or absent keys. Argument: range(0) = N.
+ */
+template<typename Hashmap, bool Hit>
+static void CompositeLookup(benchmark::State& state) {
+    using Key = typename Hashmap::key_type;
+    const KeySet<Key> keys(state.range(0));
+    Hashmap map;
+    for (uint32_t i = 0; i < keys.present.size(); ++i) map[keys.present[i]] = i;
+
+    std::vector<Key> queries = Hit ? keys.present : keys.absent;
+    std::mt19937 gen(123);
+    std::shuffle(queries.begin(), queries.end(), gen);
+
+    size_t idx = 0;
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        auto it = map.find(queries[idx]);
+        sum += it != map.end() ? it->second : 1;
+        if (++idx == queries.size()) idx = 0;
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["key_bytes"] = sizeof(Key);
+}
+
+template<typename Hashmap>
+static void BM_CompositeLookupHit(benchmark::State& state) { CompositeLookup<Hashmap, true>(state); }
+
+template<typename Hashmap>
+static void BM_CompositeLookupMiss(benchmark::State& state) { CompositeLookup<Hashmap, false>(state); }
+
+/**
+ * @brief Tables that fit in L1/L2, in the LLC, and well beyond it.
+ */
+static void SizeArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("N")->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+}
+
+#define REGISTER_COMPOSITE(...)                                                  \
+    BENCHMARK_TEMPLATE(BM_CompositeInsert, __VA_ARGS__)->Apply(SizeArgs);       \
+    BENCHMARK_TEMPLATE(BM_CompositeLookupHit, __VA_ARGS__)->Apply(SizeArgs);    \
+    BENCHMARK_TEMPLATE(BM_CompositeLookupMiss, __VA_ARGS__)->Apply(SizeArgs)
+
+#define REGISTER_KEY(Key)                          \
+    REGISTER_COMPOSITE(StdMap<Key>);               \
+    REGISTER_COMPOSITE(StdMap<Key, BytesHash>);    \
+    REGISTER_COMPOSITE(AbslMap<Key>);              \
+    REGISTER_COMPOSITE(AbslMap<Key, BytesHash>);   \
+    REGISTER_COMPOSITE(RobinMap<Key>);             \
+    REGISTER_COMPOSITE(RobinMap<Key, BytesHash>);  \
+    REGISTER_COMPOSITE(PhmapMap<Key>);             \
+    REGISTER_COMPOSITE(PhmapMap<Key, BytesHash>)
+
+// Register benchmarks
+REGISTER_KEY(TenantId);
+REGISTER_KEY(TenantShardId);
+REGISTER_KEY(Key16);
+REGISTER_KEY(Key32);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,173 @@
+/**
+ * @file composite_keys.h
+ * @brief Composite and fixed-width binary key types, and two ways to hash them.
+ *
+ * Key types:
+ * - TenantId: std::pair<int, int>, a (tenant, id) pair.
+ * - TenantShardId: std::tuple<int, int, int>, a (tenant, shard, id) triple.
+ * - Key16 / Key32: 16- and 32-byte trivially copyable ids (UUIDs, digests).
+ *
+ * Hashers:
+ * - CombineHash: hashes every field with std::hash and folds them with
+ *   boost's hash_combine, the composite hash most code writes by hand.
+ * - BytesHash: hashes the object bytes of the key as 64-bit words in
+ *   independent lanes, without looking at its fields.
+ *
+ * absl::Hash and phmap::Hash combine pairs and tuples natively; Key16/Key32
+ * provide AbslHashValue for absl, hash_value (phmap::HashState) for phmap
+ * and std::hash (CombineHash) for the rest.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include "parallel_hashmap/phmap_utils.h"
+
+using TenantId = std::pair<int, int>;
+using TenantShardId = std::tuple<int, int, int>;
+
+/**
+ * @brief 16-byte binary id, e.g. a UUID.
+ */
+struct Key16 {
+    uint64_t words[2];
+
+    friend bool operator==(const Key16& a, const Key16& b) {
+        return a.words[0] == b.words[0] && a.words[1] == b.words[1];
+    }
+
+    template<typename H>
+    friend H AbslHashValue(H h, const Key16& key) {
+        return H::combine(std::move(h), key.words[0], key.words[1]);
+    }
+
+    /// Picked by phmap::Hash ahead of std::hash.
+    friend size_t hash_value(const Key16& key) {
+        return phmap::HashState().combine(0, key.words[0], key.words[1]);
+    }
+};
+
+/**
+ * @brief 32-byte binary id, e.g. a SHA-256 digest.
+ */
+struct Key32 {
+    uint64_t words[4];
+
+    friend bool operator==(const Key32& a, const Key32& b) {
+        return a.words[0] == b.words[0] && a.words[1] == b.words[1] &&
+               a.words[2] == b.words[2] && a.words[3] == b.words[3];
+    }
+
+    template<typename H>
+    friend H AbslHashValue(H h, const Key32& key) {
+        return H::combine(std::move(h), key.words[0], key.words[1], key.words[2], key.words[3]);
+    }
+
+    /// Picked by phmap::Hash ahead of std::hash.
+    friend size_t hash_value(const Key32& key) {
+        return phmap::HashState().combine(0, key.words[0], key.words[1], key.words[2], key.words[3]);
+    }
+};
+
+/// boost::hash_combine.
+inline size_t HashCombine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * @brief Field-by-field std::hash folded with HashCombine.
+ */
+template<typename Key>
+struct CombineHash;
+
+template<typename A, typename B>
+struct CombineHash<std::pair<A, B>> {
+    size_t operator()(const std::pair<A, B>& key) const noexcept {
+        return HashCombine(std::hash<A>{}(key.first), std::hash<B>{}(key.second));
+    }
+};
+
+template<typename... Ts>
+struct CombineHash<std::tuple<Ts...>> {
+    size_t operator()(const std::tuple<Ts...>& key) const noexcept {
+        return std::apply([](const Ts&... fields) {
+            size_t seed = 0;
+            ((seed = HashCombine(seed, std::hash<Ts>{}(fields))), ...);
+            return seed;
+        }, key);
+    }
+};
+
+template<>
+struct CombineHash<Key16> {
+    size_t operator()(const Key16& key) const noexcept {
+        return HashCombine(std::hash<uint64_t>{}(key.words[0]), std::hash<uint64_t>{}(key.words[1]));
+    }
+};
+
+template<>
+struct CombineHash<Key32> {
+    size_t operator()(const Key32& key) const noexcept {
+        size_t seed = 0;
+        for (uint64_t word : key.words) seed = HashCombine(seed, std::hash<uint64_t>{}(word));
+        return seed;
+    }
+};
+
+template<>
+struct std::hash<Key16> : CombineHash<Key16> {};
+
+template<>
+struct std::hash<Key32> : CombineHash<Key32> {};
+
+/**
+ * @brief Hash of the object bytes of a key that has no padding.
+ *
+ * Every 8-byte word is mixed in its own lane with a multiply and rotate (as
+ * in an xxHash64 stripe), so the multiplies do not depend on each other and
+ * the word count is a compile-time constant the compiler can unroll or
+ * vectorize. Lanes are then summed (rotated apart) and avalanched once. A
+ * size that is not a multiple of 8 reads its last word overlapping the
+ * previous one.
+ *
+ * Only valid when equal keys have equal bytes, i.e. no padding: true for
+ * all key types in this file.
+ */
+template<typename Key>
+struct BytesHash {
+    static_assert(sizeof(Key) >= 8, "BytesHash reads whole 64-bit words");
+
+    size_t operator()(const Key& key) const noexcept {
+        constexpr size_t kWords = (sizeof(Key) + 7) / 8;
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&key);
+
+        uint64_t lanes[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            uint64_t word;
+            std::memcpy(&word, bytes + (i + 1 < kWords ? i * 8 : sizeof(Key) - 8), 8);
+            lanes[i] = Rotl(kPrime2 * (i + 1) + word * kPrime2, 31) * kPrime1;
+        }
+
+        uint64_t h = kPrime5 + sizeof(Key);
+        for (size_t i = 0; i < kWords; ++i) h += Rotl(lanes[i], static_cast<int>(i * 7 + 1));
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return static_cast<size_t>(h);
+    }
+
+private:
+    static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+    static constexpr uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+};
@@ -0,0 +1,189 @@
+/**
+ * @file concurrent_map_benchmarks.cpp
+ * @brief Read-mostly lookup tables shared by many threads.
+ *
+ * Every thread runs a stream of operations on one shared table of N keys:
+ * lookups of random present keys, and with probability `write_ppm` / 10^6
+ * an overwrite of a random key's value. 0.1% writes (1000 ppm) is the
+ * read-mostly case; 0 and 1% bracket it. Contenders:
+ * - RcuAdapter: RcuMap (rcu_map.h), wait-free reads of immutable snapshots,
+ *   each write copies and republishes the table.
+ * - SharedMutexAdapter: one map behind a std::shared_mutex.
+ * - ParallelAdapter: phmap::parallel_flat_hash_map with 16 internally
+ *   locked submaps (std::shared_mutex each).
+ *
+ * Reports operations/sec over all threads (items_per_second, real time).
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "parallel_hashmap/phmap.h"
+#include "rcu_map.h"
+#include "benchmark_data.h"
+
+/**
+ * @brief RcuMap with the interface the benchmark drives.
+ */
+template<typename Map>
+class RcuAdapter {
+public:
+    explicit RcuAdapter(const std::vector<int>& keys) {
+        map_.update([&](Map& map) {
+            for (int key : keys) map[key] = key;
+        });
+    }
+
+    bool lookup(int key, int& value) const {
+        return map_.read([&](const Map& map) {
+            auto it = map.find(key);
+            if (it == map.end()) return false;
+            value = it->second;
+            return true;
+        });
+    }
+
+    void store(int key, int value) {
+        map_.update([&](Map& map) { map[key] = value; });
+    }
+
+private:
+    RcuMap<Map> map_;
+};
+
+/**
+ * @brief A map behind one reader-writer lock.
+ */
+template<typename Map>
+class SharedMutexAdapter {
+public:
+    explicit SharedMutexAdapter(const std::vector<int>& keys) {
+        for (int key : keys) map_[key] = key;
+    }
+
+    bool lookup(int key, int& value) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = map_.find(key);
+        if (it == map_.end()) return false;
+        value = it->second;
+        return true;
+    }
+
+    void store(int key, int value) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        map_[key] = value;
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    Map map_;
+};
+
+/**
+ * @brief phmap's sharded map, locking one of its 2^4 submaps per operation.
+ */
+class ParallelAdapter {
+public:
+    using Map = phmap::parallel_flat_hash_map<int, int, phmap::priv::hash_default_hash<int>,
+                                              phmap::priv::hash_default_eq<int>,
+                                              std::allocator<std::pair<const int, int>>, 4, std::shared_mutex>;
+
+    explicit ParallelAdapter(const std::vector<int>& keys) {
+        map_.reserve(keys.size());
+        for (int key : keys) map_.insert_or_assign(key, key);
+    }
+
+    bool lookup(int key, int& value) const {
+        return map_.if_contains(key, [&](const Map::value_type& entry) { value = entry.second; });
+    }
+
+    void store(int key, int value) { map_.insert_or_assign(key, value); }
+
+private:
+    Map map_;
+};
+
+// Table and keys shared by the threads of the running benchmark, built in Setup.
+template<typename Adapter>
+static std::unique_ptr<Adapter> g_table;
+static std::vector<int> g_keys;
+
+template<typename Adapter>
+static void SetupTable(const benchmark::State& state) {
+    g_keys = GenerateDistinctEvenKeys(state.range(0), 42);
+    g_table<Adapter> = std::make_unique<Adapter>(g_keys);
+}
+
+template<typename Adapter>
+static void TeardownTable(const benchmark::State&) {
+    g_table<Adapter>.reset();
+    g_keys.clear();
+}
+
+/**
+ * @brief Mixed lookups and overwrites on the shared table.
+ * Arguments: range(0) = N keys, range(1) = writes per million operations.
+ */
+template<typename Adapter>
+static void BM_ReadMostly(benchmark::State& state) {
+    Adapter& table = *g_table<Adapter>;
+    const uint64_t write_ppm = state.range(1);
+    // xorshift64: cheap enough not to show up next to a lookup.
+    uint64_t rng = 0x9E3779B97F4A7C15ULL * (state.thread_index() + 1);
+    auto next = [&] {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return rng;
+    };
+
+    int64_t sum = 0;
+    for (auto _ : state) {
+        const uint64_t r = next();
+        const int key = g_keys[(r >> 32) % g_keys.size()];
+        if ((r & 0xffffffff) % 1000000 < write_ppm) {
+            table.store(key, static_cast<int>(r));
+        } else {
+            int value = 0;
+            table.lookup(key, value);
+            sum += value;
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Small and large tables at 0%, 0.1% and 1% writes, on 1 .. all hardware threads.
+ */
+static void ReadMostlyArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "write_ppm"});
+    for (int64_t n : {int64_t{1} << 12, int64_t{1} << 16}) {
+        for (int64_t write_ppm : {0, 1000, 10000}) {
+            bench->Args({n, write_ppm});
+        }
+    }
+    bench->ThreadRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    bench->UseRealTime();
+}
+
+#define REGISTER_READ_MOSTLY(...)                             \
+    BENCHMARK_TEMPLATE(BM_ReadMostly, __VA_ARGS__)            \
+        ->Setup(SetupTable<__VA_ARGS__>)                      \
+        ->Teardown(TeardownTable<__VA_ARGS__>)                \
+        ->Apply(ReadMostlyArgs)
+
+// Register benchmarks
+REGISTER_READ_MOSTLY(RcuAdapter<absl::flat_hash_map<int, int>>);
+REGISTER_READ_MOSTLY(SharedMutexAdapter<absl::flat_hash_map<int, int>>);
+REGISTER_READ_MOSTLY(SharedMutexAdapter<std::unordered_map<int, int>>);
+REGISTER_READ_MOSTLY(ParallelAdapter);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+/**
+ * @file count_min_sketch.h
+ * @brief Count-Min sketch with conservative update.
+ *
+ * A depth x width matrix of counters. Every key maps to one counter per row;
+ * its estimated count is the minimum of those counters, which never
+ * underestimates and overestimates by at most about e * N / width with
+ * probability 1 - e^-depth (N = stream length).
+ *
+ * Conservative update only raises the counters that equal the current
+ * minimum, which keeps the same guarantee with much smaller overestimates
+ * on skewed streams. Memory is fixed: width * depth * 4 bytes, no matter how
+ * many distinct keys the stream has.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "absl/hash/hash.h"
+
+template<typename Key, typename Hash = absl::Hash<Key>>
+class CountMinSketch {
+public:
+    /**
+     * @param width Counters per row, rounded up to a power of two.
+     * @param depth Number of rows (independent hash functions).
+     */
+    CountMinSketch(size_t width, size_t depth) : depth_(std::max<size_t>(depth, 1)) {
+        width_ = 1;
+        while (width_ < width) width_ *= 2;
+        counters_.assign(width_ * depth_, 0);
+    }
+
+    /**
+     * @brief Adds one occurrence of @p key (conservative update).
+     */
+    void add(const Key& key) {
+        size_t cells[kMaxDepth];
+        const size_t depth = locate(key, cells);
+        uint32_t min = std::numeric_limits<uint32_t>::max();
+        for (size_t i = 0; i < depth; ++i) min = std::min(min, counters_[cells[i]]);
+        for (size_t i = 0; i < depth; ++i) {
+            if (counters_[cells[i]] == min) counters_[cells[i]] = min + 1;
+        }
+    }
+
+    /**
+     * @brief Estimated number of occurrences of @p key (never below the true count).
+     */
+    uint32_t estimate(const Key& key) const {
+        size_t cells[kMaxDepth];
+        const size_t depth = locate(key, cells);
+        uint32_t min = std::numeric_limits<uint32_t>::max();
+        for (size_t i = 0; i < depth; ++i) min = std::min(min, counters_[cells[i]]);
+        return min;
+    }
+
+    size_t width() const { return width_; }
+    size_t depth() const { return depth_; }
+    /// Heap bytes of the counter matrix.
+    size_t allocated_bytes() const { return counters_.capacity() * sizeof(uint32_t); }
+
+private:
+    static constexpr size_t kMaxDepth = 16;
+
+    // Row i uses h1 + i * h2 (Kirsch-Mitzenmacher double hashing), so one
+    // 64-bit hash serves every row.
+    size_t locate(const Key& key, size_t* cells) const {
+        const uint64_t h = hash_(key);
+        const uint64_t h1 = h & 0xffffffffu;
+        const uint64_t h2 = (h >> 32) | 1;
+        const size_t depth = std::min(depth_, kMaxDepth);
+        for (size_t i = 0; i < depth; ++i) {
+            cells[i] = i * width_ + ((h1 + i * h2) & (width_ - 1));
+        }
+        return depth;
+    }
+
+    size_t width_ = 0;
+    size_t depth_ = 0;
+    std::vector<uint32_t> counters_;  ///< Row-major depth x width.
+    Hash hash_;
+};
@@ -0,0 +1,192 @@
+/**
+ * @file group_by_benchmarks.cpp
+ * @brief Columnar GROUP BY with count/sum/min/max over several value columns.
+ *
+ * Input is a key column plus `Columns` int64 value columns (structure of
+ * arrays). Two ways of keeping the per-group aggregates are compared:
+ * - BM_GroupByInline: the map's value is a struct holding every aggregate,
+ *   updated row by row (one map lookup per row, all columns at once).
+ * - BM_GroupByDense: the map only assigns each key a dense group id; the
+ *   aggregates live in separate arrays indexed by that id and are updated
+ *   column by column, as a vectorized query engine would.
+ *
+ * `items_per_second` is rows per second.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+#include "benchmark_data.h"
+
+/**
+ * @brief All aggregates of one group, stored inline as the map's value.
+ */
+template<size_t Columns>
+struct GroupAggregates {
+    static constexpr size_t kColumns = Columns;
+
+    int64_t count = 0;
+    int64_t sum[Columns] = {};
+    int64_t min[Columns];
+    int64_t max[Columns];
+
+    GroupAggregates() {
+        std::fill(std::begin(min), std::end(min), std::numeric_limits<int64_t>::max());
+        std::fill(std::begin(max), std::end(max), std::numeric_limits<int64_t>::min());
+    }
+};
+
+/**
+ * @brief Aggregates of all groups, one dense array per aggregate and column.
+ */
+template<size_t Columns>
+struct DenseAggregates {
+    std::vector<int64_t> count;
+    std::vector<int64_t> sum[Columns];
+    std::vector<int64_t> min[Columns];
+    std::vector<int64_t> max[Columns];
+
+    size_t size() const { return count.size(); }
+
+    void AddGroup() {
+        count.push_back(0);
+        for (size_t c = 0; c < Columns; ++c) {
+            sum[c].push_back(0);
+            min[c].push_back(std::numeric_limits<int64_t>::max());
+            max[c].push_back(std::numeric_limits<int64_t>::min());
+        }
+    }
+};
+
+/**
+ * @brief Key column with range(1) distinct keys and @p columns value columns of range(0) rows.
+ */
+struct ColumnarInput {
+    std::vector<int> keys;
+    std::vector<std::vector<int64_t>> values;  ///< values[c][row]
+
+    ColumnarInput(const benchmark::State& state, size_t columns)
+        : keys(GenerateRandomData(state.range(0), state.range(1))), values(columns, std::vector<int64_t>(keys.size())) {
+        std::mt19937_64 gen(7);
+        std::uniform_int_distribution<int64_t> dis(-1000000, 1000000);
+        for (auto& column : values) {
+            for (int64_t& v : column) v = dis(gen);
+        }
+    }
+};
+
+/**
+ * @brief Aggregate structs stored in the map, updated row by row.
+ */
+template<typename Hashmap>
+static void BM_GroupByInline(benchmark::State& state) {
+    constexpr size_t kColumns = Hashmap::mapped_type::kColumns;
+    const ColumnarInput input(state, kColumns);
+    size_t groups = 0;
+
+    for (auto _ : state) {
+        Hashmap map;
+        for (size_t i = 0; i < input.keys.size(); ++i) {
+            auto& agg = map[input.keys[i]];
+            agg.count++;
+            for (size_t c = 0; c < kColumns; ++c) {
+                const int64_t v = input.values[c][i];
+                agg.sum[c] += v;
+                agg.min[c] = std::min(agg.min[c], v);
+                agg.max[c] = std::max(agg.max[c], v);
+            }
+        }
+        groups = map.size();
+        benchmark::DoNotOptimize(map);
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.keys.size());
+    state.counters["groups"] = static_cast<double>(groups);
+}
+
+/**
+ * @brief Map assigns dense group ids; aggregates are updated column by column.
+ *
+ * The map stores id + 1, so a freshly inserted (value-initialized) entry
+ * reads 0 and is recognized as a new group without a second lookup.
+ */
+template<typename Hashmap, size_t Columns>
+static void BM_GroupByDense(benchmark::State& state) {
+    const ColumnarInput input(state, Columns);
+    std::vector<uint32_t> group_ids(input.keys.size());
+    size_t groups = 0;
+
+    for (auto _ : state) {
+        Hashmap map;
+        DenseAggregates<Columns> aggs;
+        for (size_t i = 0; i < input.keys.size(); ++i) {
+            uint32_t& id = map[input.keys[i]];
+            if (id == 0) {
+                aggs.AddGroup();
+                id = static_cast<uint32_t>(aggs.size());
+            }
+            group_ids[i] = id - 1;
+        }
+
+        for (uint32_t g : group_ids) aggs.count[g]++;
+        for (size_t c = 0; c < Columns; ++c) {
+            const auto& column = input.values[c];
+            for (size_t i = 0; i < column.size(); ++i) {
+                const uint32_t g = group_ids[i];
+                aggs.sum[c][g] += column[i];
+                aggs.min[c][g] = std::min(aggs.min[c][g], column[i]);
+                aggs.max[c][g] = std::max(aggs.max[c][g], column[i]);
+            }
+        }
+        groups = aggs.size();
+        benchmark::DoNotOptimize(aggs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.keys.size());
+    state.counters["groups"] = static_cast<double>(groups);
+}
+
+/**
+ * @brief 1M rows, from a handful of groups up to (nearly) one group per row.
+ */
+static void GroupByArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"rows", "groups"});
+    for (int64_t groups : {int64_t{16}, int64_t{1} << 10, int64_t{1} << 16, int64_t{1} << 20}) {
+        bench->Args({int64_t{1} << 20, groups});
+    }
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_GroupByInline, std::unordered_map<int, GroupAggregates<1>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, absl::flat_hash_map<int, GroupAggregates<1>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, robin_hood::unordered_map<int, GroupAggregates<1>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, phmap::flat_hash_map<int, GroupAggregates<1>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, SparseHashMap<int, GroupAggregates<1>>)->Apply(GroupByArgs);
+
+BENCHMARK_TEMPLATE(BM_GroupByDense, std::unordered_map<int, uint32_t>, 1)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, absl::flat_hash_map<int, uint32_t>, 1)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, robin_hood::unordered_map<int, uint32_t>, 1)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, phmap::flat_hash_map<int, uint32_t>, 1)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, SparseHashMap<int, uint32_t>, 1)->Apply(GroupByArgs);
+
+BENCHMARK_TEMPLATE(BM_GroupByInline, std::unordered_map<int, GroupAggregates<4>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, absl::flat_hash_map<int, GroupAggregates<4>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, robin_hood::unordered_map<int, GroupAggregates<4>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, phmap::flat_hash_map<int, GroupAggregates<4>>)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByInline, SparseHashMap<int, GroupAggregates<4>>)->Apply(GroupByArgs);
+
+BENCHMARK_TEMPLATE(BM_GroupByDense, std::unordered_map<int, uint32_t>, 4)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, absl::flat_hash_map<int, uint32_t>, 4)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, robin_hood::unordered_map<int, uint32_t>, 4)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, phmap::flat_hash_map<int, uint32_t>, 4)->Apply(GroupByArgs);
+BENCHMARK_TEMPLATE(BM_GroupByDense, SparseHashMap<int, uint32_t>, 4)->Apply(GroupByArgs);
+
+BENCHMARK_MAIN();
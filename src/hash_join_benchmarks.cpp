@@ -0,0 +1,290 @@
+/**
+ * @file hash_join_benchmarks.cpp
+ * @brief Build/probe hash join over two generated columnar relations.
+ *
+ * The build relation R has unique keys (a primary key); the probe relation S
+ * references them (a foreign key). Each join:
+ * 1. Builds a map from R.key to its row id.
+ * 2. Probes it with every S.key and records matching (build row, probe row) pairs.
+ * 3. Materializes the payload columns of both sides for every match.
+ *
+ * Two strategies run with every contender:
+ * - BM_HashJoin: one map over all of R.
+ * - BM_RadixJoin: R and S are first scattered into partitions by key hash,
+ *   then each partition is joined with its own small, cache-resident map.
+ *
+ * Parameters (benchmark arguments):
+ * - build / probe: number of rows of R and S.
+ * - sel_pct: percentage of S rows that find a match.
+ * - skew: Zipf exponent of the S keys, in hundredths (0 = uniform, 100 = 1.0).
+ * - payload: number of int64 payload columns on each side.
+ *
+ * `items_per_second` counts input tuples (|R| + |S|); `output_tuples_per_second`
+ * counts joined tuples produced.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+#include "benchmark_data.h"
+
+/**
+ * @brief A relation stored column by column.
+ */
+struct Relation {
+    std::vector<int> keys;
+    std::vector<std::vector<int64_t>> payload;  ///< payload[c][row]
+
+    size_t size() const { return keys.size(); }
+};
+
+/**
+ * @brief Build side: @p rows distinct even keys, each with @p payload_cols payload values.
+ */
+Relation MakeBuildRelation(size_t rows, size_t payload_cols) {
+    Relation rel;
+    rel.keys = GenerateDistinctEvenKeys(rows, 42);
+    rel.payload.assign(payload_cols, std::vector<int64_t>(rows));
+    for (size_t c = 0; c < payload_cols; ++c) {
+        for (size_t i = 0; i < rows; ++i) rel.payload[c][i] = static_cast<int64_t>(i * (c + 1));
+    }
+    return rel;
+}
+
+/**
+ * @brief Probe side: keys drawn from the build keys with Zipf skew.
+ *
+ * A row matches with probability @p selectivity; non-matching rows use the
+ * same skewed draw with the low bit set, which is never a build key.
+ */
+Relation MakeProbeRelation(const Relation& build, size_t rows, double selectivity, double skew, size_t payload_cols) {
+    ZipfGenerator zipf(build.size(), skew, 7);
+    std::mt19937 gen(11);
+    std::bernoulli_distribution match(selectivity);
+
+    Relation rel;
+    rel.keys.resize(rows);
+    for (int& key : rel.keys) {
+        key = build.keys[zipf()];
+        if (!match(gen)) key |= 1;
+    }
+    rel.payload.assign(payload_cols, std::vector<int64_t>(rows));
+    for (size_t c = 0; c < payload_cols; ++c) {
+        for (size_t i = 0; i < rows; ++i) rel.payload[c][i] = static_cast<int64_t>(i + c);
+    }
+    return rel;
+}
+
+/**
+ * @brief Join output: matching row ids plus the materialized payload columns.
+ *
+ * Buffers are sized once for the worst case (every probe row matches) and
+ * reused across iterations, so allocation is not part of the measurement.
+ */
+struct JoinOutput {
+    std::vector<uint32_t> build_rows;
+    std::vector<uint32_t> probe_rows;
+    std::vector<std::vector<int64_t>> columns;  ///< Build payload columns, then probe payload columns.
+    size_t matches = 0;
+
+    JoinOutput(const Relation& build, const Relation& probe)
+        : build_rows(probe.size()), probe_rows(probe.size()),
+          columns(build.payload.size() + probe.payload.size(), std::vector<int64_t>(probe.size())) {}
+
+    void Emit(uint32_t build_row, uint32_t probe_row) {
+        build_rows[matches] = build_row;
+        probe_rows[matches] = probe_row;
+        ++matches;
+    }
+
+    // Gathers the payload of every match (late materialization).
+    void Materialize(const Relation& build, const Relation& probe) {
+        for (size_t c = 0; c < build.payload.size(); ++c) {
+            const auto& src = build.payload[c];
+            auto& dst = columns[c];
+            for (size_t i = 0; i < matches; ++i) dst[i] = src[build_rows[i]];
+        }
+        for (size_t c = 0; c < probe.payload.size(); ++c) {
+            const auto& src = probe.payload[c];
+            auto& dst = columns[build.payload.size() + c];
+            for (size_t i = 0; i < matches; ++i) dst[i] = src[probe_rows[i]];
+        }
+    }
+};
+
+/**
+ * @brief Relations of one benchmark configuration, decoded from the arguments.
+ */
+struct JoinInput {
+    Relation build;
+    Relation probe;
+
+    explicit JoinInput(const benchmark::State& state)
+        : build(MakeBuildRelation(state.range(0), state.range(4))),
+          probe(MakeProbeRelation(build, state.range(1), state.range(2) / 100.0, state.range(3) / 100.0, state.range(4))) {}
+};
+
+static void ReportJoin(benchmark::State& state, const JoinInput& input, const JoinOutput& output) {
+    state.SetItemsProcessed(state.iterations() * (input.build.size() + input.probe.size()));
+    state.counters["output_tuples"] = static_cast<double>(output.matches);
+    state.counters["output_tuples_per_second"] = benchmark::Counter(
+        static_cast<double>(output.matches) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Classic hash join: one map over the whole build relation.
+ */
+template<typename Hashmap>
+static void BM_HashJoin(benchmark::State& state) {
+    const JoinInput input(state);
+    JoinOutput output(input.build, input.probe);
+
+    for (auto _ : state) {
+        Hashmap map;
+        map.reserve(input.build.size());
+        for (size_t i = 0; i < input.build.size(); ++i) {
+            map[input.build.keys[i]] = static_cast<uint32_t>(i);
+        }
+
+        output.matches = 0;
+        for (size_t i = 0; i < input.probe.size(); ++i) {
+            auto it = map.find(input.probe.keys[i]);
+            if (it != map.end()) output.Emit(it->second, static_cast<uint32_t>(i));
+        }
+        output.Materialize(input.build, input.probe);
+        benchmark::DoNotOptimize(output.columns.data());
+    }
+
+    ReportJoin(state, input, output);
+}
+
+/**
+ * @brief Keys and row ids of a relation scattered into radix partitions.
+ */
+struct Partitioned {
+    std::vector<int> keys;
+    std::vector<uint32_t> rows;
+    std::vector<size_t> offsets;  ///< Partition p is [offsets[p], offsets[p + 1]).
+
+    Partitioned(size_t rows_count, size_t partitions) : keys(rows_count), rows(rows_count), offsets(partitions + 1) {}
+};
+
+// Partition by the top bits of a multiplicative hash, so the partition id is
+// unrelated to the bits the contenders' own hashes use within a partition.
+inline size_t PartitionOf(int key, int bits) {
+    return bits == 0 ? 0 : (static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+}
+
+/**
+ * @brief Two-pass radix scatter: histogram, prefix sum, then copy.
+ */
+inline void Scatter(const std::vector<int>& keys, int bits, Partitioned& out) {
+    const size_t partitions = out.offsets.size() - 1;
+    std::vector<size_t> cursor(partitions, 0);
+    for (int key : keys) cursor[PartitionOf(key, bits)]++;
+
+    size_t sum = 0;
+    for (size_t p = 0; p < partitions; ++p) {
+        out.offsets[p] = sum;
+        sum += cursor[p];
+        cursor[p] = out.offsets[p];
+    }
+    out.offsets[partitions] = sum;
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const size_t dst = cursor[PartitionOf(keys[i], bits)]++;
+        out.keys[dst] = keys[i];
+        out.rows[dst] = static_cast<uint32_t>(i);
+    }
+}
+
+/**
+ * @brief Radix bits so that one partition of the build side holds about
+ *        kPartitionRows rows, small enough for its map to stay in L2.
+ */
+inline int RadixBits(size_t build_rows) {
+    constexpr size_t kPartitionRows = size_t{1} << 13;
+    int bits = 0;
+    while ((build_rows >> bits) > kPartitionRows) ++bits;
+    return bits;
+}
+
+/**
+ * @brief Radix-partitioned hash join: scatter both sides, then join partition by partition.
+ */
+template<typename Hashmap>
+static void BM_RadixJoin(benchmark::State& state) {
+    const JoinInput input(state);
+    JoinOutput output(input.build, input.probe);
+    const int bits = RadixBits(input.build.size());
+    const size_t partitions = size_t{1} << bits;
+    Partitioned build_parts(input.build.size(), partitions);
+    Partitioned probe_parts(input.probe.size(), partitions);
+
+    for (auto _ : state) {
+        Scatter(input.build.keys, bits, build_parts);
+        Scatter(input.probe.keys, bits, probe_parts);
+
+        output.matches = 0;
+        for (size_t p = 0; p < partitions; ++p) {
+            Hashmap map;
+            map.reserve(build_parts.offsets[p + 1] - build_parts.offsets[p]);
+            for (size_t i = build_parts.offsets[p]; i < build_parts.offsets[p + 1]; ++i) {
+                map[build_parts.keys[i]] = build_parts.rows[i];
+            }
+            for (size_t i = probe_parts.offsets[p]; i < probe_parts.offsets[p + 1]; ++i) {
+                auto it = map.find(probe_parts.keys[i]);
+                if (it != map.end()) output.Emit(it->second, probe_parts.rows[i]);
+            }
+        }
+        output.Materialize(input.build, input.probe);
+        benchmark::DoNotOptimize(output.columns.data());
+    }
+
+    ReportJoin(state, input, output);
+    state.counters["partitions"] = static_cast<double>(partitions);
+}
+
+/**
+ * @brief Argument grid.
+ *
+ * Main grid: build sizes from L1-resident to DRAM-resident against a fixed
+ * probe side, times selectivity and skew, with two payload columns.
+ * Payload sweep: one mid-size configuration with 0 to 8 payload columns.
+ */
+static void JoinArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"build", "probe", "sel_pct", "skew", "payload"});
+    constexpr int64_t kProbeRows = int64_t{1} << 20;
+    for (int64_t build : {int64_t{1} << 10, int64_t{1} << 16, int64_t{1} << 20}) {
+        for (int64_t selectivity : {10, 50, 100}) {
+            for (int64_t skew : {0, 100}) {
+                bench->Args({build, kProbeRows, selectivity, skew, 2});
+            }
+        }
+    }
+    for (int64_t payload : {0, 1, 4, 8}) {
+        bench->Args({int64_t{1} << 16, kProbeRows, 100, 0, payload});
+    }
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_HashJoin, std::unordered_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_HashJoin, absl::flat_hash_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_HashJoin, robin_hood::unordered_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_HashJoin, phmap::flat_hash_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_HashJoin, SparseHashMap<int, uint32_t>)->Apply(JoinArgs);
+
+BENCHMARK_TEMPLATE(BM_RadixJoin, std::unordered_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_RadixJoin, absl::flat_hash_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_RadixJoin, robin_hood::unordered_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_RadixJoin, phmap::flat_hash_map<int, uint32_t>)->Apply(JoinArgs);
+BENCHMARK_TEMPLATE(BM_RadixJoin, SparseHashMap<int, uint32_t>)->Apply(JoinArgs);
+
+BENCHMARK_MAIN();
@@ -7,9 +7,14 @@
  * - absl::flat_hash_map (Google Abseil)
  * - robin_hood::unordered_map (Martinus Robin Hood)
  * - phmap::flat_hash_map (Parallel Hashmap)
+ * - CompactCounterMap (8/16-bit inline counters, see compact_counter_map.h)
+ * - SparseHashMap (bitmap-indexed sparse groups, see sparse_hash_map.h)
  * 
  * Benchmarks cover:
  * - Histogram Sort: Measuring insertion performance and frequency counting.
+ *
+ * With --interference=SPEC (see interference.h) every histogram benchmark
+ * also runs next to noisy-neighbor threads, as BM_HistogramSort<...>/interference.
  */
 
 #include <benchmark/benchmark.h>
@@ -21,44 +26,11 @@
 #include "absl/container/flat_hash_map.h"
 #include "robin_hood.h"
 #include "parallel_hashmap/phmap.h"
-
-/**
- * @brief Generates a vector of integers in ascending order.
- * @param size Number of elements to generate.
- * @return std::vector<int> Vector containing [0, 1, ..., size-1].
- */
-std::vector<int> GenerateAscendingData(size_t size) {
-    std::vector<int> data(size);
-    std::iota(data.begin(), data.end(), 0);
-    return data;
-}
-
-/**
- * @brief Generates a vector of integers in descending order.
- * @param size Number of elements to generate.
- * @return std::vector<int> Vector containing [size-1, size-2, ..., 0].
- */
-std::vector<int> GenerateDescendingData(size_t size) {
-    std::vector<int> data(size);
-    std::iota(data.rbegin(), data.rend(),0);
-    return data;
-}
-
-/**
- * @brief Generates a vector of random integers.
- * Uses a fixed seed (42) for reproducible benchmark results.
- * @param size Number of elements to generate.
- * @return std::vector<int> Vector containing random integers between 0 and size.
- */
-std::vector<int> GenerateRandomData(size_t size) {
-    std::vector<int> data(size);
-    std::mt19937 gen(42); // Fixed seed for reproducibility
-    std::uniform_int_distribution<> dis(0, static_cast<int>(size));
-    for (auto& val : data) {
-        val = dis(gen);
-    }
-    return data;
-}
+#include "compact_counter_map.h"
+#include "sparse_hash_map.h"
+#include "memory_usage.h"
+#include "benchmark_data.h"
+#include "interference.h"
 
 /**
  * @brief Performs a histogram sort using the specified Hashmap type.
@@ -97,12 +69,19 @@ std::vector<int> histogramSort(std::vector<int>& data){
  * Measures the time taken to perform the histogram sort operation
  * on a copy of the random data.
  * 
+ * Arguments: range(0) is the input length N, range(1) the number of
+ * distinct keys, so map-size effects can be separated from input-length
+ * effects.
+ * 
+ * Reports `bytes_per_entry`: heap bytes of the filled counting map divided
+ * by the number of distinct keys.
+ * 
  * @tparam Hashmap The hashmap implementation to benchmark.
  * @param state Google Benchmark state object.
  */
 template<typename Hashmap>
 static void BM_HistogramSort(benchmark::State& state){
-    auto data = GenerateRandomData(state.range(0));
+    auto data = GenerateRandomData(state.range(0), state.range(1));
     for (auto _ : state) {
         state.PauseTiming();
         std::vector<int> copy = data;
@@ -110,15 +89,65 @@ static void BM_HistogramSort(benchmark::State& state){
         histogramSort<Hashmap>(copy);
     }
     state.SetComplexityN(state.range(0));
+
+    Hashmap counts;
+    const size_t bytes = BuildAndMeasure(counts, [&] {
+        for (int val : data) counts[val]++;
+    });
+    state.counters["bytes_per_entry"] = static_cast<double>(bytes) / counts.size();
+}
+
+/**
+ * @brief Argument grid for BM_HistogramSort.
+ * 
+ * Input lengths N follow the original Range(256, 1<<16); for each N the
+ * distinct-key count sweeps 16, 256, 4096, ... up to all-unique (N).
+ */
+static void HistogramArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "distinct"});
+    for (int64_t n : benchmark::CreateRange(256, 1<<16, 8)) {
+        for (int64_t distinct = 16; distinct < n; distinct *= 16) {
+            bench->Args({n, distinct});
+        }
+        bench->Args({n, n});
+    }
 }
 
 // Register benchmarks
-BENCHMARK_TEMPLATE(BM_HistogramSort, std::unordered_map<int, int>)->Range(256, 1<<16)->Complexity();
-BENCHMARK_TEMPLATE(BM_HistogramSort, absl::flat_hash_map<int, int>)->Range(256, 1<<16)->Complexity();
-BENCHMARK_TEMPLATE(BM_HistogramSort, robin_hood::unordered_map<int, int>)->Range(256, 1<<16)->Complexity();
-BENCHMARK_TEMPLATE(BM_HistogramSort, phmap::flat_hash_map<int, int>)->Range(256, 1<<16)->Complexity();
+BENCHMARK_TEMPLATE(BM_HistogramSort, std::unordered_map<int, int>)->Apply(HistogramArgs);
+BENCHMARK_TEMPLATE(BM_HistogramSort, absl::flat_hash_map<int, int>)->Apply(HistogramArgs);
+BENCHMARK_TEMPLATE(BM_HistogramSort, robin_hood::unordered_map<int, int>)->Apply(HistogramArgs);
+BENCHMARK_TEMPLATE(BM_HistogramSort, phmap::flat_hash_map<int, int>)->Apply(HistogramArgs);
+BENCHMARK_TEMPLATE(BM_HistogramSort, SparseHashMap<int, int>)->Apply(HistogramArgs);
+BENCHMARK_TEMPLATE(BM_HistogramSort, CompactCounterMap<int, uint8_t>)->Apply(HistogramArgs);
+BENCHMARK_TEMPLATE(BM_HistogramSort, CompactCounterMap<int, uint16_t>)->Apply(HistogramArgs);
+
+// The same grid again under the --interference threads, as BM_HistogramSort<...>/interference.
+#define REGISTER_HISTOGRAM_UNDER_INTERFERENCE(...)                                          \
+    benchmark::RegisterBenchmark("BM_HistogramSort<" #__VA_ARGS__ ">/interference",         \
+                                 BM_HistogramSort<__VA_ARGS__>)                             \
+        ->Apply(HistogramArgs)                                                              \
+        ->Apply(WithInterference)
+
+int main(int argc, char** argv) {
+    const bool interference = ParseInterferenceFlag(&argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
 
-BENCHMARK_MAIN();
+    if (interference) {
+        REGISTER_HISTOGRAM_UNDER_INTERFERENCE(std::unordered_map<int, int>);
+        REGISTER_HISTOGRAM_UNDER_INTERFERENCE(absl::flat_hash_map<int, int>);
+        REGISTER_HISTOGRAM_UNDER_INTERFERENCE(robin_hood::unordered_map<int, int>);
+        REGISTER_HISTOGRAM_UNDER_INTERFERENCE(phmap::flat_hash_map<int, int>);
+        REGISTER_HISTOGRAM_UNDER_INTERFERENCE(SparseHashMap<int, int>);
+        REGISTER_HISTOGRAM_UNDER_INTERFERENCE(CompactCounterMap<int, uint8_t>);
+        REGISTER_HISTOGRAM_UNDER_INTERFERENCE(CompactCounterMap<int, uint16_t>);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
 
 
 
@@ -0,0 +1,124 @@
+/**
+ * @file hashmap_growth.cpp
+ * @brief Cost of growing a map from empty: throughput and worst-case operation latency.
+ *
+ * A map that doubles by rehashing everything at once makes one insert in ~N
+ * pay for N entries; at 16M entries that single insert takes tens of
+ * milliseconds. IncrementalRehashMap (incremental_rehash_map.h) spreads the
+ * same work over the following operations instead.
+ *
+ * Benchmarks cover:
+ * - BM_GrowthThroughput: N inserts into an empty map (no reserve), untimed
+ *   per operation, for the plain insert rate.
+ * - BM_GrowthLatency: the same inserts, each followed by a lookup of an
+ *   earlier key, with every operation timed. Reports `max_op_us`, the
+ *   longest single operation, and `p99_op_ns` / `p999_op_ns`. The clock
+ *   reads add the same fixed cost to every contender.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+#include "incremental_rehash_map.h"
+
+/**
+ * @brief i-th key of the insert sequence: distinct for every i < 2^32, in scrambled order.
+ */
+static int GrowthKey(uint32_t i) {
+    return static_cast<int>(i * 2654435761u);
+}
+
+/**
+ * @brief N inserts into an empty map. Argument: range(0) = N.
+ */
+template<typename Hashmap>
+static void BM_GrowthThroughput(benchmark::State& state) {
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        {
+            Hashmap map;
+            for (uint32_t i = 0; i < n; ++i) map[GrowthKey(i)] = static_cast<int>(i);
+            benchmark::DoNotOptimize(map);
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+/**
+ * @brief Value at quantile @p q of @p samples (reorders them).
+ */
+static uint32_t Quantile(std::vector<uint32_t>& samples, double q) {
+    const size_t k = std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+/**
+ * @brief N timed insert + lookup pairs into an empty map. Argument: range(0) = N.
+ */
+template<typename Hashmap>
+static void BM_GrowthLatency(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    std::vector<uint32_t> op_ns(2 * static_cast<size_t>(n));
+    uint64_t max_ns = 0;
+    int64_t sum = 0;
+
+    for (auto _ : state) {
+        {
+            Hashmap map;
+            for (uint32_t i = 0; i < n; ++i) {
+                const Clock::time_point t0 = Clock::now();
+                map[GrowthKey(i)] = static_cast<int>(i);
+                const Clock::time_point t1 = Clock::now();
+                auto it = map.find(GrowthKey(i / 2));
+                sum += it->second;
+                const Clock::time_point t2 = Clock::now();
+                op_ns[2 * i] = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+                op_ns[2 * i + 1] = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+            }
+            state.PauseTiming();
+        }
+        max_ns = std::max<uint64_t>(max_ns, *std::max_element(op_ns.begin(), op_ns.end()));
+        state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(sum);
+
+    state.SetItemsProcessed(state.iterations() * op_ns.size());
+    state.counters["max_op_us"] = max_ns / 1000.0;
+    state.counters["p999_op_ns"] = Quantile(op_ns, 0.999);
+    state.counters["p99_op_ns"] = Quantile(op_ns, 0.99);
+}
+
+/**
+ * @brief 1M and 16M entries, run once each: a single pass already holds every growth step.
+ */
+static void GrowthArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("N")->Arg(1 << 20)->Arg(1 << 24)->Iterations(1)->Unit(benchmark::kMillisecond);
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_GrowthThroughput, std::unordered_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthThroughput, absl::flat_hash_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthThroughput, robin_hood::unordered_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthThroughput, phmap::flat_hash_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthThroughput, SparseHashMap<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthThroughput, IncrementalRehashMap<int, int>)->Apply(GrowthArgs);
+
+BENCHMARK_TEMPLATE(BM_GrowthLatency, std::unordered_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthLatency, absl::flat_hash_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthLatency, robin_hood::unordered_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthLatency, phmap::flat_hash_map<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthLatency, SparseHashMap<int, int>)->Apply(GrowthArgs);
+BENCHMARK_TEMPLATE(BM_GrowthLatency, IncrementalRehashMap<int, int>)->Apply(GrowthArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,233 @@
+/**
+ * @file hashmap_load_factor.cpp
+ * @brief Load-factor sweep: how much speed each contender trades for memory.
+ *
+ * Every contender normally runs at its default load factor. Here each map is
+ * driven to a target load factor and measured for:
+ * - Insert: filling a pre-sized table up to the target load.
+ * - Lookup hit / miss: random lookups of present and absent keys.
+ *
+ * Each result carries the achieved `load_factor` and `bytes_per_entry`, so
+ * plotting time against bytes per entry (scripts/plot_pareto.py) gives the
+ * speed/memory Pareto curve of each contender.
+ *
+ * How the target is reached:
+ * - std::unordered_map: max_load_factor(target), then reserve.
+ * - Open addressing maps: reserve a capacity C, then insert target * C keys,
+ *   so the table never grows and sits exactly at the target. absl and phmap
+ *   cap at 7/8; robin_hood is instantiated with MaxLoadFactor100 = 95 so the
+ *   sweep can go up to 90%.
+ * - SparseHashMap: max_load_factor(target), then reserve; it doubles once
+ *   the target is exceeded, like std.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+#include "memory_usage.h"
+#include "benchmark_data.h"
+
+using RobinHood95 = robin_hood::unordered_map<int, int, robin_hood::hash<int>, std::equal_to<int>, 95>;
+
+/**
+ * @brief Number of buckets/slots of a table.
+ */
+template<typename Hashmap>
+size_t TableCapacity(const Hashmap& map) {
+    if constexpr (requires { map.bucket_count(); }) {
+        return map.bucket_count();
+    } else {
+        return map.mask() + 1;
+    }
+}
+
+/**
+ * @brief How a contender is driven to a target load factor.
+ *
+ * Default (open addressing): reserve room for `base` entries and return how
+ * many keys make the resulting capacity exactly `load` full.
+ */
+template<typename Hashmap>
+struct LoadFactorControl {
+    static constexpr int kMaxLoadPercent = 87;  // absl / phmap grow past 7/8
+
+    static size_t Prepare(Hashmap& map, size_t base, double load) {
+        map.reserve(base);
+        return static_cast<size_t>(load * TableCapacity(map));
+    }
+};
+
+template<>
+struct LoadFactorControl<RobinHood95> {
+    static constexpr int kMaxLoadPercent = 90;  // headroom below the 95% growth threshold
+
+    static size_t Prepare(RobinHood95& map, size_t base, double load) {
+        map.reserve(base);
+        return static_cast<size_t>(load * TableCapacity(map));
+    }
+};
+
+template<>
+struct LoadFactorControl<std::unordered_map<int, int>> {
+    static constexpr int kMaxLoadPercent = 400;  // chaining allows several entries per bucket
+
+    static size_t Prepare(std::unordered_map<int, int>& map, size_t base, double load) {
+        map.max_load_factor(static_cast<float>(load));
+        map.reserve(base);
+        return base;
+    }
+};
+
+template<>
+struct LoadFactorControl<SparseHashMap<int, int>> {
+    static constexpr int kMaxLoadPercent = 90;  // linear probing degrades sharply beyond this
+
+    static size_t Prepare(SparseHashMap<int, int>& map, size_t base, double load) {
+        map.max_load_factor(static_cast<float>(load));
+        map.reserve(base);
+        // Same float -> double rounding as the map's own growth check.
+        return static_cast<size_t>(static_cast<double>(map.max_load_factor()) * TableCapacity(map));
+    }
+};
+
+/**
+ * @brief A table filled to its target load, plus keys to look up.
+ */
+template<typename Hashmap>
+struct LoadedTable {
+    Hashmap map;
+    std::vector<int> keys;  ///< Present keys, in insertion order.
+    size_t bytes = 0;       ///< Heap footprint of the table.
+};
+
+template<typename Hashmap>
+void BuildLoadedTable(LoadedTable<Hashmap>& table, size_t base, double load) {
+    size_t count = 0;
+    {
+        Hashmap sizing;
+        count = LoadFactorControl<Hashmap>::Prepare(sizing, base, load);
+    }
+    table.keys = GenerateDistinctEvenKeys(count, 42);
+    table.bytes = BuildAndMeasure(table.map, [&] {
+        LoadFactorControl<Hashmap>::Prepare(table.map, base, load);
+        for (int key : table.keys) table.map[key] = key;
+    });
+}
+
+template<typename Hashmap>
+void ReportLoad(benchmark::State& state, const LoadedTable<Hashmap>& table) {
+    state.counters["elements"] = static_cast<double>(table.map.size());
+    state.counters["load_factor"] = static_cast<double>(table.map.size()) / TableCapacity(table.map);
+    state.counters["bytes_per_entry"] = static_cast<double>(table.bytes) / table.map.size();
+}
+
+/**
+ * @brief Time to fill a pre-sized table up to the target load factor.
+ * Arguments: range(0) = base size, range(1) = target load factor in percent.
+ */
+template<typename Hashmap>
+static void BM_LoadFactorInsert(benchmark::State& state) {
+    LoadedTable<Hashmap> table;
+    const double load = state.range(1) / 100.0;
+    BuildLoadedTable(table, state.range(0), load);
+
+    for (auto _ : state) {
+        {
+            state.PauseTiming();
+            Hashmap map;
+            LoadFactorControl<Hashmap>::Prepare(map, state.range(0), load);
+            state.ResumeTiming();
+            for (int key : table.keys) {
+                map[key] = key;
+            }
+            benchmark::DoNotOptimize(map);
+            // Destruction is not timed.
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * table.keys.size());
+    ReportLoad(state, table);
+}
+
+/**
+ * @brief Random lookups of present (Hit = true) or absent (Hit = false) keys.
+ * Arguments: range(0) = base size, range(1) = target load factor in percent.
+ */
+template<typename Hashmap, bool Hit>
+static void BM_LoadFactorLookup(benchmark::State& state) {
+    LoadedTable<Hashmap> table;
+    BuildLoadedTable(table, state.range(0), state.range(1) / 100.0);
+
+    std::vector<int> lookups = table.keys;
+    std::mt19937 gen(123);
+    std::shuffle(lookups.begin(), lookups.end(), gen);
+    if constexpr (!Hit) {
+        for (int& key : lookups) key |= 1;
+    }
+
+    size_t lookup_idx = 0;
+    size_t found = 0;
+    for (auto _ : state) {
+        found += table.map.find(lookups[lookup_idx]) != table.map.end();
+        if (++lookup_idx == lookups.size()) lookup_idx = 0;
+    }
+    benchmark::DoNotOptimize(found);
+
+    state.SetItemsProcessed(state.iterations());
+    ReportLoad(state, table);
+}
+
+template<typename Hashmap>
+static void BM_LoadFactorLookupHit(benchmark::State& state) {
+    BM_LoadFactorLookup<Hashmap, true>(state);
+}
+
+template<typename Hashmap>
+static void BM_LoadFactorLookupMiss(benchmark::State& state) {
+    BM_LoadFactorLookup<Hashmap, false>(state);
+}
+
+/**
+ * @brief Argument grid: an in-cache and an out-of-cache base size, times
+ *        every target load factor the contender can hold without growing.
+ */
+template<typename Hashmap>
+static void LoadFactorArgs(benchmark::internal::Benchmark* bench) {
+    static constexpr int kLoadPercents[] = {25, 40, 50, 60, 70, 80, 87, 90, 100, 200, 400};
+    bench->ArgNames({"N", "load_pct"});
+    for (int64_t base : {int64_t{1} << 14, int64_t{1} << 20}) {
+        for (int load : kLoadPercents) {
+            if (load <= LoadFactorControl<Hashmap>::kMaxLoadPercent) bench->Args({base, load});
+        }
+    }
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_LoadFactorInsert, std::unordered_map<int, int>)->Apply(LoadFactorArgs<std::unordered_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorInsert, absl::flat_hash_map<int, int>)->Apply(LoadFactorArgs<absl::flat_hash_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorInsert, RobinHood95)->Apply(LoadFactorArgs<RobinHood95>);
+BENCHMARK_TEMPLATE(BM_LoadFactorInsert, phmap::flat_hash_map<int, int>)->Apply(LoadFactorArgs<phmap::flat_hash_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorInsert, SparseHashMap<int, int>)->Apply(LoadFactorArgs<SparseHashMap<int, int>>);
+
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupHit, std::unordered_map<int, int>)->Apply(LoadFactorArgs<std::unordered_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupHit, absl::flat_hash_map<int, int>)->Apply(LoadFactorArgs<absl::flat_hash_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupHit, RobinHood95)->Apply(LoadFactorArgs<RobinHood95>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupHit, phmap::flat_hash_map<int, int>)->Apply(LoadFactorArgs<phmap::flat_hash_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupHit, SparseHashMap<int, int>)->Apply(LoadFactorArgs<SparseHashMap<int, int>>);
+
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupMiss, std::unordered_map<int, int>)->Apply(LoadFactorArgs<std::unordered_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupMiss, absl::flat_hash_map<int, int>)->Apply(LoadFactorArgs<absl::flat_hash_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupMiss, RobinHood95)->Apply(LoadFactorArgs<RobinHood95>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupMiss, phmap::flat_hash_map<int, int>)->Apply(LoadFactorArgs<phmap::flat_hash_map<int, int>>);
+BENCHMARK_TEMPLATE(BM_LoadFactorLookupMiss, SparseHashMap<int, int>)->Apply(LoadFactorArgs<SparseHashMap<int, int>>);
+
+BENCHMARK_MAIN();
@@ -4,65 +4,349 @@
 #include <algorithm>
 #include <random>
 #include <unordered_map>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <atomic>
 #include "absl/container/flat_hash_map.h"
 #include "robin_hood.h"
 #include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+#include "cache_info.h"
+#include "map_introspection.h"
+#include "memory_baseline.h"
+#include "memory_usage.h"
+#include "shm_hash_map.h"
+#include "interference.h"
+#include "benchmark_data.h"
 
-// Helper function to generate Random Data
-// We generate 2*size range to ensure some spread, but we return 'size' elements.
-std::vector<int> GenerateRandomData(size_t size) {
-    std::vector<int> data(size);
-    std::mt19937 gen(42); // Fixed seed for reproducibility
-    std::uniform_int_distribution<> dis(0, static_cast<int>(size) * 2); 
-    for (auto& val : data) {
-        val = dis(gen);
+// Lookup modes for BM_RandomAccess.
+// kDependent:   every lookup returns the key of the next lookup (pointer chasing
+//               through the map), so lookups cannot overlap -> pure latency.
+// kIndependent: keys come from a precomputed shuffled stream and the returned
+//               values are accumulated, so the out-of-order core is free to keep
+//               several lookups in flight -> throughput.
+enum class LookupMode { kDependent, kIndependent };
+
+// The BM_RandomAccess table links the distinct keys of `data` into a single
+// random cycle: the value stored under each key is the next key of the cycle.
+// Both lookup modes share this layout, so they measure exactly the same table.
+std::vector<int> CycleOrder(const std::vector<int>& data, std::mt19937& gen) {
+    std::vector<int> keys = data;
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    std::shuffle(keys.begin(), keys.end(), gen);
+    return keys;
+}
+
+template<typename Hashmap>
+void FillCycleMap(Hashmap& map, const std::vector<int>& keys) {
+    map.reserve(keys.size()); // Reserve to avoid rehash during insertion if possible
+    for (size_t i = 0; i < keys.size(); ++i) {
+        map[keys[i]] = keys[(i + 1) % keys.size()];
+    }
+}
+
+// ShmHashMap as a BM_RandomAccess contender. The table is written through
+// the creating mapping, which is dropped once it is built; lookups go through
+// a second, read-only mapping of the segment, as they would in a reader
+// process. The segment is not heap memory, so BuildAndMeasure falls back to
+// allocated_bytes(), the segment size.
+class ShmReaderTable {
+public:
+    using value_type = ShmHashMap<int, int>::value_type;
+
+    void build(const std::vector<int>& keys) {
+        static std::atomic<int> counter{0};
+        const std::string name =
+            "/random_access." + std::to_string(::getpid()) + "." + std::to_string(counter.fetch_add(1));
+        auto writer = ShmHashMap<int, int>::create(name, keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            writer.insert(keys[i], keys[(i + 1) % keys.size()]);
+        }
+        reader_ = ShmHashMap<int, int>::open(name);
     }
-    return data;
+
+    const value_type* find(int key) const { return reader_.find(key); }
+    size_t size() const { return reader_.size(); }
+    size_t bucket_count() const { return reader_.bucket_count(); }
+    size_t allocated_bytes() const { return reader_.allocated_bytes(); }
+
+private:
+    ShmHashMap<int, int> reader_;
+};
+
+void FillCycleMap(ShmReaderTable& map, const std::vector<int>& keys) {
+    map.build(keys);
+}
+
+// Table footprint per generated input element for a given contender, averaged
+// over one octave of sizes so that power-of-two capacity rounding evens out.
+// Measured once per contender and used to turn a footprint target into N.
+template<typename Hashmap>
+double FootprintPerElement() {
+    static const double bytes_per_element = [] {
+        constexpr size_t kBase = 1 << 14;
+        constexpr int kSteps = 4;
+        double total = 0;
+        for (int step = 0; step < kSteps; ++step) {
+            const size_t size = kBase + step * (kBase / kSteps);
+            auto data = GenerateSpreadRandomData(size);
+            std::mt19937 gen(123);
+            auto keys = CycleOrder(data, gen);
+            Hashmap map;
+            const size_t bytes = BuildAndMeasure(map, [&] { FillCycleMap(map, keys); });
+            total += static_cast<double>(bytes) / size;
+        }
+        return total / kSteps;
+    }();
+    return bytes_per_element;
+}
+
+const std::vector<CacheLevel>& DataCaches() {
+    static const std::vector<CacheLevel> caches = DetectDataCaches();
+    return caches;
 }
 
+// Layout statistics of every table BM_RandomAccess built, keyed by contender
+// and footprint target. Both lookup modes build the same table, so each table
+// is introspected once; --introspection_out=FILE dumps them all as JSON.
+static std::mutex g_stats_mutex;
+static std::map<std::pair<std::string, size_t>, TableStats> g_table_stats;
+
 template<typename Hashmap>
-static void BM_RandomAccess(benchmark::State& state) {
-    const size_t size = state.range(0);
+const TableStats& TableStatsFor(const char* contender, size_t target_bytes, const Hashmap& map) {
+    std::lock_guard<std::mutex> lock(g_stats_mutex);
+    auto key = std::make_pair(std::string(contender), target_bytes);
+    auto it = g_table_stats.find(key);
+    if (it == g_table_stats.end()) {
+        it = g_table_stats.emplace(key, Introspect(map)).first;
+    }
+    return it->second;
+}
+
+static void WriteTableStats(const std::string& path) {
+    std::ofstream out(path);
+    out << "{\"tables\": [\n";
+    bool first = true;
+    for (const auto& [key, stats] : g_table_stats) {
+        out << (first ? "" : ",\n") << "  {\"contender\": \"" << key.first
+            << "\", \"target_bytes\": " << key.second << ", \"stats\": ";
+        WriteJson(out, stats);
+        out << '}';
+        first = false;
+    }
+    out << "\n]}\n";
+}
+
+// Latency floor (MemoryLatencyFloorNs) per targeted footprint. main() fills it
+// before any benchmark runs, so no floor is measured while interference
+// threads are running and quiet and /interference runs share the same floors.
+static std::map<size_t, double> g_latency_floor_ns;
+
+// The benchmark argument is the targeted table footprint in bytes, not the
+// element count, so that every contender is sampled at the same distance
+// from each cache boundary. The measured footprint and the cache level it
+// fits in are reported with every result.
+template<typename Hashmap, LookupMode Mode>
+static void BM_RandomAccess(benchmark::State& state, const char* contender) {
+    const size_t target_bytes = state.range(0);
+    const size_t size = std::max<size_t>(16, static_cast<size_t>(target_bytes / FootprintPerElement<Hashmap>()));
     // Generate data
-    auto data = GenerateRandomData(size);
-    
+    auto data = GenerateSpreadRandomData(size);
+
     // Setup map (not timed)
+    std::mt19937 gen(123);
+    auto keys = CycleOrder(data, gen);
     Hashmap map;
-    map.reserve(size); // Reserve to avoid rehash during insertion if possible
-    for (int val : data) {
-        map[val] = val; 
+    const size_t footprint = BuildAndMeasure(map, [&] { FillCycleMap(map, keys); });
+    const TableStats& stats = TableStatsFor(contender, target_bytes, map);
+
+    const auto start = std::chrono::steady_clock::now();
+    if constexpr (Mode == LookupMode::kDependent) {
+        int key = keys.front();
+        for (auto _ : state) {
+            // The next key is only known once this lookup has finished.
+            key = map.find(key)->second;
+            benchmark::DoNotOptimize(key);
+        }
+    } else {
+        // Prepare lookup keys: we use the inserted data but shuffled
+        // to simulate random access patterns to existing keys.
+        std::vector<int> lookups = data;
+        std::shuffle(lookups.begin(), lookups.end(), gen);
+
+        size_t lookup_idx = 0;
+        long long sum = 0;
+        for (auto _ : state) {
+            // Read the value so the lookup cannot be reduced to a probe.
+            sum += map.find(lookups[lookup_idx])->second;
+
+            // Advance index
+            lookup_idx++;
+            if (lookup_idx >= lookups.size()) {
+                lookup_idx = 0;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
     }
-    
-    // Prepare lookup keys: we use the inserted data but shuffled
-    // to simulate random access patterns to existing keys.
-    std::vector<int> lookups = data;
-    std::mt19937 gen(123);
-    std::shuffle(lookups.begin(), lookups.end(), gen);
-    
-    size_t lookup_idx = 0;
-    const size_t lookup_mask = lookups.size() - 1; // Used if size is power of 2, else use modulo
-    
+    const auto stop = std::chrono::steady_clock::now();
+
+    state.SetComplexityN(size);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["elements"] = static_cast<double>(size);
+    state.counters["footprint_bytes"] = static_cast<double>(footprint);
+    // Express the result in units of the machine's own dependent-load latency
+    // for a working set of the targeted size (see BM_PointerChase).
+    const auto floor = g_latency_floor_ns.find(target_bytes);
+    if (floor != g_latency_floor_ns.end()) {
+        const double lookup_ns = std::chrono::duration<double, std::nano>(stop - start).count() / state.iterations();
+        state.counters["latency_floor_ns"] = floor->second;
+        state.counters["x_latency_floor"] = lookup_ns / floor->second;
+    }
+    state.counters["load_factor"] = stats.load_factor;
+    state.counters["avg_probe"] = stats.avg_probe;
+    state.counters["max_probe"] = static_cast<double>(stats.max_probe);
+    state.SetLabel(CacheLevelFor(footprint, DataCaches()));
+}
+
+// Baseline: random pointer chase through a working set of state.range(0)
+// bytes, one cache line per hop. This is the latency floor for any lookup
+// whose table has the same footprint.
+static void BM_PointerChase(benchmark::State& state) {
+    const size_t bytes = state.range(0);
+    const auto ring = BuildChaseRing(bytes);
+    const ChaseLine* p = Chase(ring.data(), ring.size());
+
     for (auto _ : state) {
-        // Get next key to lookup
-        int key = lookups[lookup_idx];
-        
-        // Perform lookup
-        benchmark::DoNotOptimize(map.find(key));
-        
-        // Advance index
-        lookup_idx++;
-        if (lookup_idx >= lookups.size()) {
-            lookup_idx = 0;
-        }
+        p = p->next;
+        benchmark::DoNotOptimize(p);
     }
-    
-    state.SetComplexityN(state.range(0));
+
     state.SetItemsProcessed(state.iterations());
+    state.SetLabel(CacheLevelFor(bytes, DataCaches()));
 }
 
-BENCHMARK_TEMPLATE(BM_RandomAccess, std::unordered_map<int, int>)->Range(256, 1<<20)->Complexity();
-BENCHMARK_TEMPLATE(BM_RandomAccess, absl::flat_hash_map<int, int>)->Range(256, 1<<20)->Complexity();
-BENCHMARK_TEMPLATE(BM_RandomAccess, robin_hood::unordered_map<int, int>)->Range(256, 1<<20)->Complexity();
-BENCHMARK_TEMPLATE(BM_RandomAccess, phmap::flat_hash_map<int, int>)->Range(256, 1<<20)->Complexity();
+// Baseline: streaming bandwidth. Every thread reads (or writes) its own
+// buffer of state.range(0) bytes front to back.
+static void BM_SequentialRead(benchmark::State& state) {
+    std::vector<uint64_t> buffer(state.range(0) / sizeof(uint64_t), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SequentialRead(buffer));
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size() * sizeof(uint64_t));
+    state.SetLabel(CacheLevelFor(state.range(0), DataCaches()));
+}
+
+static void BM_SequentialWrite(benchmark::State& state) {
+    std::vector<uint64_t> buffer(state.range(0) / sizeof(uint64_t));
+    uint64_t value = 0;
+    for (auto _ : state) {
+        SequentialWrite(buffer, ++value);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size() * sizeof(uint64_t));
+    state.SetLabel(CacheLevelFor(state.range(0), DataCaches()));
+}
 
-BENCHMARK_MAIN();
+// Registers @p fn as @p name and, with --interference, a second time as
+// `name/interference` running under the interference threads.
+template<typename Fn>
+static std::vector<benchmark::internal::Benchmark*> RegisterWithInterference(const std::string& name, Fn fn,
+                                                                             const char* contender) {
+    std::vector<benchmark::internal::Benchmark*> benches{benchmark::RegisterBenchmark(name.c_str(), fn, contender)};
+    if (GlobalInterference().enabled()) {
+        benches.push_back(
+            benchmark::RegisterBenchmark((name + "/interference").c_str(), fn, contender)->Apply(WithInterference));
+    }
+    return benches;
+}
+
+// Each contender is registered in both modes next to each other so latency
+// and throughput can be read side by side.
+#define REGISTER_RANDOM_ACCESS(...)                                                              \
+    do {                                                                                         \
+        auto benches = RegisterWithInterference(                                                 \
+            "BM_RandomAccess<" #__VA_ARGS__ ", LookupMode::kDependent>",                         \
+            BM_RandomAccess<__VA_ARGS__, LookupMode::kDependent>, #__VA_ARGS__);                 \
+        for (auto* bench : RegisterWithInterference(                                             \
+                 "BM_RandomAccess<" #__VA_ARGS__ ", LookupMode::kIndependent>",                  \
+                 BM_RandomAccess<__VA_ARGS__, LookupMode::kIndependent>, #__VA_ARGS__)) {        \
+            benches.push_back(bench);                                                            \
+        }                                                                                        \
+        for (auto* bench : benches) {                                                            \
+            for (size_t bytes : footprints) bench->Arg(static_cast<int64_t>(bytes));             \
+            bench->Complexity();                                                                 \
+        }                                                                                        \
+    } while (0)
+
+// Largest table footprint to sweep, overridable with --max_footprint_mb=N.
+// Points past a few times the last level cache only repeat the DRAM result.
+static size_t g_max_footprint_bytes = size_t{1} << 30;
+// Where to write the table introspection JSON (--introspection_out=FILE).
+static std::string g_introspection_out;
+
+// Removes our own flags from argv before Google Benchmark parses the rest.
+static void ParseFlags(int* argc, char** argv) {
+    const char* kFootprintFlag = "--max_footprint_mb=";
+    const char* kIntrospectionFlag = "--introspection_out=";
+    int out = 1;
+    for (int i = 1; i < *argc; ++i) {
+        if (std::strncmp(argv[i], kFootprintFlag, std::strlen(kFootprintFlag)) == 0) {
+            g_max_footprint_bytes = std::strtoull(argv[i] + std::strlen(kFootprintFlag), nullptr, 10) << 20;
+        } else if (std::strncmp(argv[i], kIntrospectionFlag, std::strlen(kIntrospectionFlag)) == 0) {
+            g_introspection_out = argv[i] + std::strlen(kIntrospectionFlag);
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    *argc = out;
+}
+
+int main(int argc, char** argv) {
+    ParseInterferenceFlag(&argc, argv);
+    ParseFlags(&argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    const std::vector<size_t> footprints = CacheAwareSizes(DataCaches(), g_max_footprint_bytes);
+    for (const CacheLevel& cache : DataCaches()) {
+        benchmark::AddCustomContext("L" + std::to_string(cache.level) + "_bytes", std::to_string(cache.size_bytes));
+    }
+
+    // Memory baselines first, so the map results below can be read against them.
+    auto* chase = benchmark::RegisterBenchmark("BM_PointerChase", BM_PointerChase);
+    auto* read = benchmark::RegisterBenchmark("BM_SequentialRead", BM_SequentialRead);
+    auto* write = benchmark::RegisterBenchmark("BM_SequentialWrite", BM_SequentialWrite);
+    const int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (size_t bytes : footprints) {
+        chase->Arg(static_cast<int64_t>(bytes));
+        read->Arg(static_cast<int64_t>(bytes));
+        write->Arg(static_cast<int64_t>(bytes));
+    }
+    for (auto* bench : {read, write}) {
+        bench->Threads(1);
+        if (threads > 1) bench->Threads(threads);
+    }
+
+    REGISTER_RANDOM_ACCESS(std::unordered_map<int, int>);
+    REGISTER_RANDOM_ACCESS(absl::flat_hash_map<int, int>);
+    REGISTER_RANDOM_ACCESS(robin_hood::unordered_map<int, int>);
+    REGISTER_RANDOM_ACCESS(phmap::flat_hash_map<int, int>);
+    REGISTER_RANDOM_ACCESS(SparseHashMap<int, int>);
+    REGISTER_RANDOM_ACCESS(ShmReaderTable);
+
+    // Measured up front, on a quiet machine: see g_latency_floor_ns.
+    for (size_t bytes : footprints) g_latency_floor_ns[bytes] = MemoryLatencyFloorNs(bytes);
+
+    benchmark::RunSpecifiedBenchmarks();
+    if (!g_introspection_out.empty()) WriteTableStats(g_introspection_out);
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file hashset_benchmarks.cpp
+ * @brief Set-only workloads: deduplication, membership and set algebra.
+ *
+ * Contenders:
+ * - std::unordered_set (Standard Library)
+ * - absl::flat_hash_set (Google Abseil)
+ * - robin_hood::unordered_set (Martinus Robin Hood)
+ * - phmap::flat_hash_set (Parallel Hashmap)
+ *
+ * Benchmarks cover:
+ * - Dedup: inserting a stream with a controlled number of distinct keys.
+ * - Membership hit / miss: random lookups of present and absent keys.
+ * - Intersection / union of two sets with a controlled overlap.
+ *
+ * Inputs come from the generators in benchmark_data.h shared with the map suites.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <unordered_set>
+#include "absl/container/flat_hash_set.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "benchmark_data.h"
+#include "memory_usage.h"
+
+/**
+ * @brief Inserts a stream into an empty set, keeping the first copy of each key.
+ *
+ * Arguments: range(0) = stream length N, range(1) = number of distinct keys.
+ * Reports `bytes_per_entry` of the resulting set.
+ */
+template<typename Set>
+static void BM_SetDedup(benchmark::State& state) {
+    const auto data = GenerateRandomData(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        Set unique;
+        for (int val : data) {
+            unique.insert(val);
+        }
+        benchmark::DoNotOptimize(unique);
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+
+    Set unique;
+    const size_t bytes = BuildAndMeasure(unique, [&] {
+        for (int val : data) unique.insert(val);
+    });
+    state.counters["bytes_per_entry"] = static_cast<double>(bytes) / unique.size();
+}
+
+/**
+ * @brief Random membership tests of present (Hit = true) or absent (Hit = false) keys.
+ * Arguments: range(0) = set size.
+ */
+template<typename Set, bool Hit>
+static void BM_SetMembership(benchmark::State& state) {
+    const std::vector<int> keys = GenerateDistinctEvenKeys(state.range(0), 42);
+    Set set;
+    set.reserve(keys.size());
+    for (int key : keys) set.insert(key);
+
+    std::vector<int> lookups = keys;
+    std::mt19937 gen(123);
+    std::shuffle(lookups.begin(), lookups.end(), gen);
+    if constexpr (!Hit) {
+        for (int& key : lookups) key |= 1;
+    }
+
+    size_t lookup_idx = 0;
+    size_t found = 0;
+    for (auto _ : state) {
+        found += set.count(lookups[lookup_idx]);
+        if (++lookup_idx == lookups.size()) lookup_idx = 0;
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Set>
+static void BM_SetMembershipHit(benchmark::State& state) {
+    BM_SetMembership<Set, true>(state);
+}
+
+template<typename Set>
+static void BM_SetMembershipMiss(benchmark::State& state) {
+    BM_SetMembership<Set, false>(state);
+}
+
+/**
+ * @brief Two sets of N keys each sharing overlap_pct percent of their keys.
+ */
+template<typename Set>
+struct SetPair {
+    Set a;
+    Set b;
+
+    SetPair(size_t n, int overlap_pct) {
+        const size_t shared = n * overlap_pct / 100;
+        const std::vector<int> keys = GenerateDistinctEvenKeys(2 * n - shared, 42);
+        a.reserve(n);
+        b.reserve(n);
+        for (size_t i = 0; i < n; ++i) a.insert(keys[i]);
+        for (size_t i = n - shared; i < keys.size(); ++i) b.insert(keys[i]);
+    }
+};
+
+/**
+ * @brief Builds A ∩ B by probing B with every key of A.
+ * Arguments: range(0) = size of each set, range(1) = overlap in percent.
+ */
+template<typename Set>
+static void BM_SetIntersection(benchmark::State& state) {
+    const SetPair<Set> sets(state.range(0), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        Set result;
+        for (int key : sets.a) {
+            if (sets.b.count(key)) result.insert(key);
+        }
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * sets.a.size());
+}
+
+/**
+ * @brief Builds A ∪ B by inserting both sets into an empty one.
+ * Arguments: range(0) = size of each set, range(1) = overlap in percent.
+ */
+template<typename Set>
+static void BM_SetUnion(benchmark::State& state) {
+    const SetPair<Set> sets(state.range(0), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        Set result;
+        for (int key : sets.a) result.insert(key);
+        for (int key : sets.b) result.insert(key);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * (sets.a.size() + sets.b.size()));
+}
+
+/**
+ * @brief Stream lengths with 16, 256, 4096, ... up to all-unique distinct keys.
+ */
+static void DedupArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "distinct"});
+    for (int64_t n : benchmark::CreateRange(1 << 10, 1 << 20, 32)) {
+        for (int64_t distinct = 16; distinct < n; distinct *= 16) {
+            bench->Args({n, distinct});
+        }
+        bench->Args({n, n});
+    }
+}
+
+static void MembershipArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("N")->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+}
+
+static void SetAlgebraArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "overlap_pct"});
+    for (int64_t n : {int64_t{1} << 12, int64_t{1} << 18}) {
+        for (int64_t overlap : {0, 10, 50, 90, 100}) {
+            bench->Args({n, overlap});
+        }
+    }
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_SetDedup, std::unordered_set<int>)->Apply(DedupArgs);
+BENCHMARK_TEMPLATE(BM_SetDedup, absl::flat_hash_set<int>)->Apply(DedupArgs);
+BENCHMARK_TEMPLATE(BM_SetDedup, robin_hood::unordered_set<int>)->Apply(DedupArgs);
+BENCHMARK_TEMPLATE(BM_SetDedup, phmap::flat_hash_set<int>)->Apply(DedupArgs);
+
+BENCHMARK_TEMPLATE(BM_SetMembershipHit, std::unordered_set<int>)->Apply(MembershipArgs);
+BENCHMARK_TEMPLATE(BM_SetMembershipHit, absl::flat_hash_set<int>)->Apply(MembershipArgs);
+BENCHMARK_TEMPLATE(BM_SetMembershipHit, robin_hood::unordered_set<int>)->Apply(MembershipArgs);
+BENCHMARK_TEMPLATE(BM_SetMembershipHit, phmap::flat_hash_set<int>)->Apply(MembershipArgs);
+
+BENCHMARK_TEMPLATE(BM_SetMembershipMiss, std::unordered_set<int>)->Apply(MembershipArgs);
+BENCHMARK_TEMPLATE(BM_SetMembershipMiss, absl::flat_hash_set<int>)->Apply(MembershipArgs);
+BENCHMARK_TEMPLATE(BM_SetMembershipMiss, robin_hood::unordered_set<int>)->Apply(MembershipArgs);
+BENCHMARK_TEMPLATE(BM_SetMembershipMiss, phmap::flat_hash_set<int>)->Apply(MembershipArgs);
+
+BENCHMARK_TEMPLATE(BM_SetIntersection, std::unordered_set<int>)->Apply(SetAlgebraArgs);
+BENCHMARK_TEMPLATE(BM_SetIntersection, absl::flat_hash_set<int>)->Apply(SetAlgebraArgs);
+BENCHMARK_TEMPLATE(BM_SetIntersection, robin_hood::unordered_set<int>)->Apply(SetAlgebraArgs);
+BENCHMARK_TEMPLATE(BM_SetIntersection, phmap::flat_hash_set<int>)->Apply(SetAlgebraArgs);
+
+BENCHMARK_TEMPLATE(BM_SetUnion, std::unordered_set<int>)->Apply(SetAlgebraArgs);
+BENCHMARK_TEMPLATE(BM_SetUnion, absl::flat_hash_set<int>)->Apply(SetAlgebraArgs);
+BENCHMARK_TEMPLATE(BM_SetUnion, robin_hood::unordered_set<int>)->Apply(SetAlgebraArgs);
+BENCHMARK_TEMPLATE(BM_SetUnion, phmap::flat_hash_set<int>)->Apply(SetAlgebraArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,227 @@
+/**
+ * @file incremental_rehash_map.h
+ * @brief Open-addressing map that grows without a stop-the-world rehash.
+ *
+ * When a flat map outgrows its table it moves every entry to a table twice
+ * the size in one call, so one insert in ~N pays O(N). This map grows the
+ * way Redis dictionaries do: it allocates the larger table and keeps both
+ * while a cursor walks the old one, moving the entries of kMigrateSlots old
+ * slots on every operation. An operation therefore never does more than a
+ * constant amount of migration work.
+ *
+ * While both tables exist:
+ * - lookups try the new table first, then the old one;
+ * - inserts always go to the new table;
+ * - an entry that is accessed in the old table is moved right away, and its
+ *   old slot is marked `moved` rather than emptied, so linear-probe chains
+ *   through it stay intact.
+ *
+ * The control bytes of a new table come from calloc, which hands out large
+ * blocks as fresh zero pages, so allocating a table does not memset it
+ * either.
+ *
+ * find() returns a pointer to the entry and end() is nullptr. There is no
+ * erase and no iteration; this is a contender for insert and lookup paths.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "absl/hash/hash.h"
+
+template<typename Key, typename Value, typename Hash = absl::Hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class IncrementalRehashMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    /// Old-table slots migrated per operation while growing.
+    static constexpr size_t kMigrateSlots = 16;
+    /// The table grows (doubles) beyond this load.
+    static constexpr double kMaxLoad = 0.75;
+
+    IncrementalRehashMap() = default;
+    IncrementalRehashMap(const IncrementalRehashMap&) = delete;
+    IncrementalRehashMap& operator=(const IncrementalRehashMap&) = delete;
+    IncrementalRehashMap(IncrementalRehashMap&& other) noexcept { swap(other); }
+    IncrementalRehashMap& operator=(IncrementalRehashMap&& other) noexcept {
+        if (this != &other) {
+            IncrementalRehashMap moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+    ~IncrementalRehashMap() {
+        old_.release();
+        table_.release();
+    }
+
+    Value& operator[](const Key& key) {
+        migrate_step();
+        const size_t hash = hash_(key);
+        if (value_type* entry = table_.find(key, hash, equal_)) return entry->second;
+        if (rehashing()) {
+            if (value_type* entry = old_.find(key, hash, equal_)) return move_from_old(entry, hash)->second;
+        }
+        if (static_cast<double>(size_ + 1) > kMaxLoad * table_.capacity()) {
+            grow(table_.capacity() ? 2 * table_.capacity() : kMinCapacity);
+        }
+        ++size_;
+        return table_.emplace(hash, key, Value())->second;
+    }
+
+    iterator find(const Key& key) {
+        migrate_step();
+        const size_t hash = hash_(key);
+        if (value_type* entry = table_.find(key, hash, equal_)) return entry;
+        if (rehashing()) {
+            if (value_type* entry = old_.find(key, hash, equal_)) return move_from_old(entry, hash);
+        }
+        return nullptr;
+    }
+
+    const_iterator find(const Key& key) const {
+        const size_t hash = hash_(key);
+        if (const value_type* entry = table_.find(key, hash, equal_)) return entry;
+        return rehashing() ? old_.find(key, hash, equal_) : nullptr;
+    }
+
+    size_t count(const Key& key) const { return find(key) != nullptr; }
+    iterator end() { return nullptr; }
+    const_iterator end() const { return nullptr; }
+
+    /**
+     * @brief Makes room for @p n entries; finishes any migration in progress (blocking).
+     */
+    void reserve(size_t n) {
+        size_t capacity = table_.capacity() ? table_.capacity() : kMinCapacity;
+        while (static_cast<double>(n) > kMaxLoad * capacity) capacity *= 2;
+        if (capacity > table_.capacity()) grow(capacity);
+        while (rehashing()) migrate_step();
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    /// Slots of the current (newest) table.
+    size_t bucket_count() const { return table_.capacity(); }
+    /// True while entries are still being moved out of the previous table.
+    bool rehashing() const { return old_.ctrl != nullptr; }
+    /// Heap bytes of both tables.
+    size_t allocated_bytes() const { return table_.allocated_bytes() + old_.allocated_bytes(); }
+
+    void swap(IncrementalRehashMap& other) noexcept {
+        std::swap(table_, other.table_);
+        std::swap(old_, other.old_);
+        std::swap(cursor_, other.cursor_);
+        std::swap(size_, other.size_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+private:
+    static constexpr size_t kMinCapacity = 16;
+    static_assert(alignof(value_type) <= alignof(std::max_align_t), "slots come from malloc");
+
+    enum : uint8_t { kEmpty = 0, kFull = 1, kMoved = 2 };
+
+    struct Table {
+        uint8_t* ctrl = nullptr;
+        value_type* slots = nullptr;
+        size_t mask = 0;
+        size_t used = 0;  ///< kFull slots.
+
+        static Table allocate(size_t capacity) {
+            Table table;
+            table.ctrl = static_cast<uint8_t*>(std::calloc(capacity, 1));
+            table.slots = static_cast<value_type*>(std::malloc(capacity * sizeof(value_type)));
+            if (!table.ctrl || !table.slots) {
+                std::free(table.ctrl);
+                std::free(table.slots);
+                throw std::bad_alloc();
+            }
+            table.mask = capacity - 1;
+            return table;
+        }
+
+        void release() {
+            if (!ctrl) return;
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_t i = 0; i <= mask; ++i) {
+                    if (ctrl[i] != kEmpty) slots[i].~value_type();
+                }
+            }
+            std::free(ctrl);
+            std::free(slots);
+            *this = Table{};
+        }
+
+        size_t capacity() const { return ctrl ? mask + 1 : 0; }
+        size_t allocated_bytes() const { return capacity() * (1 + sizeof(value_type)); }
+
+        value_type* find(const Key& key, size_t hash, const KeyEqual& equal) const {
+            if (!ctrl) return nullptr;
+            for (size_t i = hash & mask;; i = (i + 1) & mask) {
+                if (ctrl[i] == kEmpty) return nullptr;
+                if (ctrl[i] == kFull && equal(slots[i].first, key)) return &slots[i];
+            }
+        }
+
+        /// Places a key known to be absent in the first empty slot of its probe chain.
+        template<typename... Args>
+        value_type* emplace(size_t hash, Args&&... args) {
+            size_t i = hash & mask;
+            while (ctrl[i] != kEmpty) i = (i + 1) & mask;
+            ctrl[i] = kFull;
+            ++used;
+            return ::new (&slots[i]) value_type(std::forward<Args>(args)...);
+        }
+    };
+
+    /// Starts migrating into a table of @p capacity slots; an unfinished migration is completed first.
+    void grow(size_t capacity) {
+        while (rehashing()) migrate_step();
+        Table larger = Table::allocate(capacity);
+        if (table_.used != 0) {
+            old_ = table_;
+            cursor_ = 0;
+        } else {
+            table_.release();
+        }
+        table_ = larger;
+    }
+
+    value_type* move_from_old(value_type* entry, size_t hash) {
+        const size_t slot = static_cast<size_t>(entry - old_.slots);
+        old_.ctrl[slot] = kMoved;
+        --old_.used;
+        return table_.emplace(hash, std::move(*entry));
+    }
+
+    /// Moves the entries of the next kMigrateSlots old slots; frees the old table when done.
+    void migrate_step() {
+        if (!rehashing()) return;
+        const size_t end = std::min(cursor_ + kMigrateSlots, old_.capacity());
+        for (; cursor_ < end; ++cursor_) {
+            if (old_.ctrl[cursor_] == kFull) move_from_old(&old_.slots[cursor_], hash_(old_.slots[cursor_].first));
+        }
+        if (cursor_ == old_.capacity() || old_.used == 0) old_.release();
+    }
+
+    Table table_;
+    Table old_;
+    size_t cursor_ = 0;  ///< Next old slot to migrate.
+    size_t size_ = 0;
+    Hash hash_;
+    KeyEqual equal_;
+};
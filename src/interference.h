@@ -0,0 +1,256 @@
+/**
+ * @file interference.h
+ * @brief Noisy-neighbor threads pinned to chosen CPUs, run alongside a benchmark.
+ *
+ * Production maps share caches, memory bandwidth and cores with other
+ * work. `--interference=SPEC` lists co-running threads as kind:cpu pairs,
+ * e.g. `--interference=llc:2,bandwidth:3,smt:1,self:0`:
+ * - llc: read-modify-writes one word per cache line over twice the last
+ *   level cache, evicting the benchmark's lines from the shared LLC.
+ * - bandwidth: copies a buffer of at least 256 MiB (8x the LLC) front to
+ *   back, using up memory bandwidth.
+ * - smt: register-only integer and floating point work with no memory
+ *   traffic; pin it to the SMT sibling of the benchmark's core to compete
+ *   for that core's execution units.
+ * - self: pins the benchmark thread itself (no extra thread), so the other
+ *   threads can be placed relative to it.
+ *
+ * Benchmarks opt in with ->Apply(WithInterference): the threads start in
+ * the benchmark's Setup, after their buffers are allocated and faulted in,
+ * and stop in its Teardown. Suites register such a copy of a benchmark
+ * under its name plus "/interference" next to the quiet one;
+ * scripts/interference_slowdown.py pairs the two and reports the slowdown.
+ * Pinning uses pthread_setaffinity_np on Linux; elsewhere threads run
+ * unpinned.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cache_info.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+enum class InterferenceKind { kLlcStreamer, kBandwidthHog, kSmtSpinner, kSelf };
+
+/**
+ * @brief One entry of an interference spec: what to run and on which CPU.
+ */
+struct InterferenceThread {
+    InterferenceKind kind;
+    int cpu;
+};
+
+/**
+ * @brief Parses "kind:cpu,kind:cpu,..." (kinds: llc, bandwidth, smt, self).
+ * @throws std::invalid_argument on a malformed spec.
+ */
+inline std::vector<InterferenceThread> ParseInterferenceSpec(const std::string& spec) {
+    std::vector<InterferenceThread> threads;
+    size_t begin = 0;
+    while (begin < spec.size()) {
+        size_t end = spec.find(',', begin);
+        if (end == std::string::npos) end = spec.size();
+        const std::string item = spec.substr(begin, end - begin);
+        const size_t colon = item.find(':');
+        const std::string kind = item.substr(0, colon);
+        const std::string cpu = colon == std::string::npos ? "" : item.substr(colon + 1);
+        int cpu_index = 0;
+        const auto [end_of_cpu, error] = std::from_chars(cpu.data(), cpu.data() + cpu.size(), cpu_index);
+        if (cpu.empty() || cpu[0] == '-' || error != std::errc() || end_of_cpu != cpu.data() + cpu.size()) {
+            throw std::invalid_argument("interference: expected kind:cpu, got '" + item + "'");
+        }
+        InterferenceThread thread{InterferenceKind::kSelf, cpu_index};
+        if (kind == "llc") {
+            thread.kind = InterferenceKind::kLlcStreamer;
+        } else if (kind == "bandwidth") {
+            thread.kind = InterferenceKind::kBandwidthHog;
+        } else if (kind == "smt") {
+            thread.kind = InterferenceKind::kSmtSpinner;
+        } else if (kind != "self") {
+            throw std::invalid_argument("interference: unknown kind '" + kind + "'");
+        }
+        threads.push_back(thread);
+        begin = end + 1;
+    }
+    return threads;
+}
+
+/**
+ * @brief Pins @p thread to @p cpu. Returns false if the platform or the CPU does not allow it.
+ */
+inline bool PinThread(std::thread::native_handle_type thread, int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+/**
+ * @brief Starts and stops the threads of one spec; buffers are kept across runs.
+ */
+class InterferenceRunner {
+public:
+    /// Sets the spec and pins the calling (benchmark) thread if it has a `self` entry.
+    void configure(std::vector<InterferenceThread> spec) {
+        spec_ = std::move(spec);
+        const size_t llc_bytes = DetectDataCaches().back().size_bytes;
+        llc_words_ = 2 * llc_bytes / sizeof(uint64_t);
+        bandwidth_words_ = std::max<size_t>(8 * llc_bytes, size_t{256} << 20) / sizeof(uint64_t);
+        buffers_.resize(spec_.size());
+        for (const InterferenceThread& entry : spec_) {
+#if defined(__linux__)
+            if (entry.kind == InterferenceKind::kSelf && !PinThread(pthread_self(), entry.cpu)) {
+                std::fprintf(stderr, "interference: cannot pin the benchmark thread to CPU %d\n", entry.cpu);
+            }
+#endif
+        }
+    }
+
+    bool enabled() const { return !spec_.empty(); }
+
+    /// Starts every thread of the spec and returns once all of them are running.
+    void start() {
+        stop_.store(false, std::memory_order_relaxed);
+        running_.store(0, std::memory_order_relaxed);
+        size_t expected = 0;
+        for (size_t i = 0; i < spec_.size(); ++i) {
+            const InterferenceThread entry = spec_[i];
+            if (entry.kind == InterferenceKind::kSelf) continue;
+            std::vector<uint64_t>& buffer = buffers_[i];
+            if (entry.kind == InterferenceKind::kLlcStreamer) buffer.resize(llc_words_, 1);
+            if (entry.kind == InterferenceKind::kBandwidthHog) buffer.resize(bandwidth_words_, 1);
+            threads_.emplace_back([this, entry, &buffer] {
+                running_.fetch_add(1, std::memory_order_release);
+                run(entry.kind, buffer);
+            });
+            if (!PinThread(threads_.back().native_handle(), entry.cpu)) {
+                std::fprintf(stderr, "interference: cannot pin a thread to CPU %d, it runs unpinned\n", entry.cpu);
+            }
+            ++expected;
+        }
+        while (running_.load(std::memory_order_acquire) < expected) std::this_thread::yield();
+    }
+
+    void stop() {
+        stop_.store(true, std::memory_order_relaxed);
+        for (std::thread& thread : threads_) thread.join();
+        threads_.clear();
+    }
+
+private:
+    /// Words per stop check for the streaming kernels (1 MiB).
+    static constexpr size_t kChunkWords = (size_t{1} << 20) / sizeof(uint64_t);
+
+    void run(InterferenceKind kind, std::vector<uint64_t>& buffer) {
+        switch (kind) {
+            case InterferenceKind::kLlcStreamer:
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < buffer.size(); i += 64 / sizeof(uint64_t)) buffer[i]++;
+                    benchmark::ClobberMemory();
+                }
+                break;
+            case InterferenceKind::kBandwidthHog: {
+                // Copy the first half onto the second, 1 MiB at a time.
+                const size_t half = buffer.size() / 2;
+                for (size_t offset = 0; !stop_.load(std::memory_order_relaxed);
+                     offset = offset + kChunkWords < half ? offset + kChunkWords : 0) {
+                    const size_t words = std::min(kChunkWords, half - offset);
+                    std::memcpy(buffer.data() + half + offset, buffer.data() + offset, words * sizeof(uint64_t));
+                    benchmark::ClobberMemory();
+                }
+                break;
+            }
+            case InterferenceKind::kSmtSpinner: {
+                uint64_t a = 1, b = 2;
+                double x = 1.0, y = 2.0;
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    for (int i = 0; i < (1 << 16); ++i) {
+                        a = a * 6364136223846793005ULL + 1442695040888963407ULL;
+                        b ^= a >> 29;
+                        x = x * 0.999999 + 1e-7;
+                        y = y * x + 0.5;
+                    }
+                    benchmark::DoNotOptimize(a);
+                    benchmark::DoNotOptimize(b);
+                    benchmark::DoNotOptimize(x);
+                    benchmark::DoNotOptimize(y);
+                }
+                break;
+            }
+            case InterferenceKind::kSelf:
+                break;
+        }
+    }
+
+    std::vector<InterferenceThread> spec_;
+    std::vector<std::vector<uint64_t>> buffers_;  ///< One per spec entry, reused across runs.
+    std::vector<std::thread> threads_;
+    size_t llc_words_ = 0;
+    size_t bandwidth_words_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> running_{0};
+};
+
+inline InterferenceRunner& GlobalInterference() {
+    static InterferenceRunner runner;
+    return runner;
+}
+
+inline void StartInterference(const benchmark::State&) { GlobalInterference().start(); }
+inline void StopInterference(const benchmark::State&) { GlobalInterference().stop(); }
+
+/**
+ * @brief Runs @p bench with the configured interference threads.
+ */
+inline void WithInterference(benchmark::internal::Benchmark* bench) {
+    bench->Setup(StartInterference)->Teardown(StopInterference);
+}
+
+/**
+ * @brief Removes --interference=SPEC from argv and configures GlobalInterference() with it.
+ *
+ * Exits with an error message if the spec is malformed.
+ * @return True if interference was requested.
+ */
+inline bool ParseInterferenceFlag(int* argc, char** argv) {
+    const char* kFlag = "--interference=";
+    int out = 1;
+    for (int i = 1; i < *argc; ++i) {
+        if (std::strncmp(argv[i], kFlag, std::strlen(kFlag)) == 0) {
+            try {
+                GlobalInterference().configure(ParseInterferenceSpec(argv[i] + std::strlen(kFlag)));
+            } catch (const std::invalid_argument& error) {
+                std::fprintf(stderr, "%s\n", error.what());
+                std::exit(1);
+            }
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    *argc = out;
+    return GlobalInterference().enabled();
+}
@@ -0,0 +1,120 @@
+/**
+ * @file lru_cache.h
+ * @brief Fixed-capacity LRU cache on top of any hash map contender.
+ *
+ * Entries live in a preallocated node array and are chained into an
+ * intrusive doubly-linked recency list by 32-bit indices (no per-entry
+ * allocation, no pointers). The map only translates a key to its node index,
+ * so swapping `IndexMap` swaps the hash table under an otherwise identical
+ * cache:
+ *
+ *     LruCache<int, uint64_t, absl::flat_hash_map<int, uint32_t>> cache(1024);
+ *
+ * `IndexMap` needs find, end, operator[], erase and reserve.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "memory_usage.h"
+
+template<typename Key, typename Value, typename IndexMap>
+class LruCache {
+public:
+    /// @throws std::invalid_argument if @p capacity is 0 or does not fit the 32-bit node indices.
+    explicit LruCache(size_t capacity) : capacity_(capacity) {
+        if (capacity == 0 || capacity >= kNil) throw std::invalid_argument("LruCache: capacity must be in [1, 2^32 - 1)");
+    }
+
+    /**
+     * @brief Looks up @p key and marks it most recently used.
+     * @return The cached value, or nullptr on a miss.
+     */
+    Value* get(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) return nullptr;
+        const uint32_t node = it->second;
+        move_to_front(node);
+        return &nodes_[node].value;
+    }
+
+    /**
+     * @brief Inserts or updates @p key, evicting the least recently used entry if full.
+     */
+    void put(const Key& key, const Value& value) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            const uint32_t node = it->second;
+            nodes_[node].value = value;
+            move_to_front(node);
+            return;
+        }
+
+        uint32_t node;
+        if (nodes_.size() < capacity_) {
+            if (nodes_.empty()) {
+                // Allocate on first use, so an empty cache costs nothing.
+                nodes_.reserve(capacity_);
+                index_.reserve(capacity_);
+            }
+            node = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back({key, value, kNil, kNil});
+        } else {
+            node = tail_;
+            unlink(node);
+            index_.erase(nodes_[node].key);
+            nodes_[node].key = key;
+            nodes_[node].value = value;
+            ++evictions_;
+        }
+        push_front(node);
+        index_[key] = node;
+    }
+
+    size_t size() const { return nodes_.size(); }
+    size_t capacity() const { return capacity_; }
+    size_t evictions() const { return evictions_; }
+    /// Approximate heap bytes, used when allocator statistics are unavailable.
+    size_t allocated_bytes() const { return nodes_.capacity() * sizeof(Node) + ApproxTableBytes(index_); }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Node {
+        Key key;
+        Value value;
+        uint32_t prev;  ///< Towards the most recently used end.
+        uint32_t next;  ///< Towards the least recently used end.
+    };
+
+    void unlink(uint32_t node) {
+        Node& n = nodes_[node];
+        if (n.prev != kNil) nodes_[n.prev].next = n.next; else head_ = n.next;
+        if (n.next != kNil) nodes_[n.next].prev = n.prev; else tail_ = n.prev;
+    }
+
+    void push_front(uint32_t node) {
+        Node& n = nodes_[node];
+        n.prev = kNil;
+        n.next = head_;
+        if (head_ != kNil) nodes_[head_].prev = node;
+        head_ = node;
+        if (tail_ == kNil) tail_ = node;
+    }
+
+    void move_to_front(uint32_t node) {
+        if (node == head_) return;
+        unlink(node);
+        push_front(node);
+    }
+
+    size_t capacity_;
+    std::vector<Node> nodes_;
+    uint32_t head_ = kNil;  ///< Most recently used.
+    uint32_t tail_ = kNil;  ///< Least recently used, the next victim.
+    size_t evictions_ = 0;
+    IndexMap index_;
+};
@@ -0,0 +1,180 @@
+/**
+ * @file lru_cache_benchmarks.cpp
+ * @brief LRU cache (lru_cache.h) backed by each hash map contender.
+ *
+ * Benchmarks cover:
+ * - BM_LruWorkload: cache-aside requests (get, and put on a miss) from a
+ *   trace over 1M keys, at several capacity-to-working-set ratios. Reports
+ *   `hit_rate` and `bytes_per_entry`; the time per item is the mean cost of
+ *   one request.
+ * - BM_LruGetHit / BM_LruPutEvict: latency of a get that hits and of a put
+ *   that evicts, on a full cache.
+ *
+ * Traces (argument `trace`):
+ * - 0: Zipf(0.99) key popularity.
+ * - 1: the same, with every 10th block of 1024 requests replaced by a scan
+ *      over never-repeated keys, the access pattern that flushes an LRU.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "lru_cache.h"
+#include "benchmark_data.h"
+#include "memory_usage.h"
+
+// Number of distinct keys in the working set of the traces.
+static constexpr size_t kWorkingSet = size_t{1} << 20;
+// Length of a trace; requests wrap around at the end.
+static constexpr size_t kTraceLength = size_t{1} << 22;
+
+template<typename IndexMap>
+using IntLru = LruCache<int, uint64_t, IndexMap>;
+
+/**
+ * @brief Request keys of trace @p trace (see file comment).
+ */
+static std::vector<int> MakeTrace(int trace) {
+    std::vector<int> keys = GenerateZipfData(kTraceLength, kWorkingSet, 0.99);
+    if (trace == 1) {
+        constexpr size_t kBlock = 1024;
+        // Scan keys start above every Zipf key, so they are always misses.
+        int scan_key = static_cast<int>(kTraceLength) + 1;
+        for (size_t block = 0; block * kBlock < keys.size(); block += 10) {
+            const size_t end = std::min(keys.size(), (block + 1) * kBlock);
+            for (size_t i = block * kBlock; i < end; ++i) keys[i] = scan_key++;
+        }
+    }
+    return keys;
+}
+
+/**
+ * @brief Cache-aside requests against a cache holding capacity_pct % of the working set.
+ * Arguments: range(0) = capacity in percent of the working set, range(1) = trace.
+ */
+template<typename IndexMap>
+static void BM_LruWorkload(benchmark::State& state) {
+    const size_t capacity = kWorkingSet * state.range(0) / 100;
+    const std::vector<int> trace = MakeTrace(static_cast<int>(state.range(1)));
+
+    // One full pass warms the cache (and measures its footprint when full).
+    IntLru<IndexMap> cache(capacity);
+    const size_t bytes = BuildAndMeasure(cache, [&] {
+        for (int key : trace) {
+            if (!cache.get(key)) cache.put(key, static_cast<uint64_t>(key));
+        }
+    });
+
+    size_t idx = 0;
+    size_t hits = 0;
+    for (auto _ : state) {
+        const int key = trace[idx];
+        if (cache.get(key)) {
+            ++hits;
+        } else {
+            cache.put(key, static_cast<uint64_t>(key));
+        }
+        if (++idx == trace.size()) idx = 0;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit_rate"] = static_cast<double>(hits) / state.iterations();
+    state.counters["bytes_per_entry"] = static_cast<double>(bytes) / cache.size();
+}
+
+/**
+ * @brief A full cache of range(0) entries, the keys it holds, and keys it does not.
+ */
+template<typename IndexMap>
+struct FullCache {
+    std::vector<int> present;
+    std::vector<int> absent;
+    IntLru<IndexMap> cache;
+
+    explicit FullCache(size_t capacity) : cache(capacity) {
+        present = GenerateDistinctEvenKeys(capacity, 42);
+        for (int key : present) cache.put(key, static_cast<uint64_t>(key));
+        std::mt19937 gen(123);
+        std::shuffle(present.begin(), present.end(), gen);
+        absent = present;
+        for (int& key : absent) key |= 1;
+    }
+};
+
+/**
+ * @brief Latency of a get that hits. Argument: range(0) = capacity.
+ */
+template<typename IndexMap>
+static void BM_LruGetHit(benchmark::State& state) {
+    FullCache<IndexMap> full(state.range(0));
+
+    size_t idx = 0;
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        sum += *full.cache.get(full.present[idx]);
+        if (++idx == full.present.size()) idx = 0;
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Latency of a put of a new key, which evicts the LRU entry. Argument: range(0) = capacity.
+ *
+ * Odd keys evict even ones and vice versa, so after one pass over the
+ * absent keys the roles swap and every put stays a miss.
+ */
+template<typename IndexMap>
+static void BM_LruPutEvict(benchmark::State& state) {
+    FullCache<IndexMap> full(state.range(0));
+
+    size_t idx = 0;
+    int flip = 1;
+    for (auto _ : state) {
+        const int key = full.present[idx] ^ flip;
+        full.cache.put(key, static_cast<uint64_t>(key));
+        if (++idx == full.present.size()) {
+            idx = 0;
+            flip ^= 1;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["evictions"] = static_cast<double>(full.cache.evictions());
+}
+
+static void WorkloadArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"capacity_pct", "trace"});
+    for (int64_t trace : {0, 1}) {
+        for (int64_t pct : {1, 10, 50}) {
+            bench->Args({pct, trace});
+        }
+    }
+}
+
+static void CapacityArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("capacity")->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_LruWorkload, std::unordered_map<int, uint32_t>)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_LruWorkload, absl::flat_hash_map<int, uint32_t>)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_LruWorkload, robin_hood::unordered_map<int, uint32_t>)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_LruWorkload, phmap::flat_hash_map<int, uint32_t>)->Apply(WorkloadArgs);
+
+BENCHMARK_TEMPLATE(BM_LruGetHit, std::unordered_map<int, uint32_t>)->Apply(CapacityArgs);
+BENCHMARK_TEMPLATE(BM_LruGetHit, absl::flat_hash_map<int, uint32_t>)->Apply(CapacityArgs);
+BENCHMARK_TEMPLATE(BM_LruGetHit, robin_hood::unordered_map<int, uint32_t>)->Apply(CapacityArgs);
+BENCHMARK_TEMPLATE(BM_LruGetHit, phmap::flat_hash_map<int, uint32_t>)->Apply(CapacityArgs);
+
+BENCHMARK_TEMPLATE(BM_LruPutEvict, std::unordered_map<int, uint32_t>)->Apply(CapacityArgs);
+BENCHMARK_TEMPLATE(BM_LruPutEvict, absl::flat_hash_map<int, uint32_t>)->Apply(CapacityArgs);
+BENCHMARK_TEMPLATE(BM_LruPutEvict, robin_hood::unordered_map<int, uint32_t>)->Apply(CapacityArgs);
+BENCHMARK_TEMPLATE(BM_LruPutEvict, phmap::flat_hash_map<int, uint32_t>)->Apply(CapacityArgs);
+
+BENCHMARK_MAIN();
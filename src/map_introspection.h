@@ -0,0 +1,264 @@
+/**
+ * @file map_introspection.h
+ * @brief Probe-length, displacement and occupancy statistics for the contenders.
+ *
+ * Explains *why* a map is fast or slow on a given table:
+ * - std::unordered_map: chain position of every key and bucket sizes,
+ *   through the standard bucket interface.
+ * - absl / phmap: number of extra probes per key, through the libraries'
+ *   own HashtableDebugAccess hooks.
+ * - robin_hood: distance from the home slot, decoded from the table's info bytes.
+ * - SparseHashMap: distance from the home slot, through its num_probes() hook.
+ *
+ * A probe length of 0 means the key was found at its first bucket, group or
+ * slot. Occupancy is reported per bucket for chained maps and per 64-byte
+ * line of the slot array for flat maps (how many entries one cache miss
+ * brings in).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/internal/hashtable_debug.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+
+/**
+ * @brief Layout statistics of one populated table.
+ */
+struct TableStats {
+    size_t size = 0;
+    size_t capacity = 0;                      ///< Buckets (chained) or slots (flat).
+    double load_factor = 0;
+    double avg_probe = 0;                     ///< Mean extra probes to find a present key.
+    size_t max_probe = 0;
+    std::vector<size_t> probe_histogram;      ///< [d] = keys found after d extra probes.
+    std::vector<size_t> occupancy_histogram;  ///< [k] = buckets / lines holding k entries.
+    std::string probe_unit;                   ///< What one probe step is for this map.
+    std::string occupancy_unit;               ///< What one occupancy cell is for this map.
+};
+
+/**
+ * @brief Records one key found after @p probes extra probes.
+ */
+inline void AddProbe(TableStats& stats, size_t probes) {
+    if (stats.probe_histogram.size() <= probes) stats.probe_histogram.resize(probes + 1);
+    stats.probe_histogram[probes]++;
+}
+
+/**
+ * @brief Derives avg_probe, max_probe and load_factor from the collected data.
+ */
+inline void FinishStats(TableStats& stats) {
+    size_t keys = 0, total = 0;
+    for (size_t d = 0; d < stats.probe_histogram.size(); ++d) {
+        keys += stats.probe_histogram[d];
+        total += d * stats.probe_histogram[d];
+        if (stats.probe_histogram[d]) stats.max_probe = d;
+    }
+    stats.avg_probe = keys ? static_cast<double>(total) / keys : 0.0;
+    stats.load_factor = stats.capacity ? static_cast<double>(stats.size) / stats.capacity : 0.0;
+}
+
+/**
+ * @brief Histogram of entries per 64-byte line of a flat slot array.
+ *
+ * Lines are identified by element address, so no access to the slot array
+ * base is needed. Lines without any entry are derived from the capacity.
+ */
+template<typename Hashmap>
+std::vector<size_t> LineOccupancy(const Hashmap& map, size_t capacity) {
+    constexpr uintptr_t kLine = 64;
+    std::vector<uintptr_t> lines;
+    lines.reserve(map.size());
+    for (const auto& entry : map) {
+        lines.push_back(reinterpret_cast<uintptr_t>(&entry) / kLine);
+    }
+    std::sort(lines.begin(), lines.end());
+
+    std::vector<size_t> histogram(1, 0);
+    size_t touched = 0;
+    for (size_t i = 0; i < lines.size();) {
+        size_t j = i;
+        while (j < lines.size() && lines[j] == lines[i]) ++j;
+        const size_t count = j - i;
+        if (histogram.size() <= count) histogram.resize(count + 1);
+        histogram[count]++;
+        ++touched;
+        i = j;
+    }
+    const size_t total_lines = (capacity * sizeof(typename Hashmap::value_type) + kLine - 1) / kLine;
+    histogram[0] = total_lines > touched ? total_lines - touched : 0;
+    return histogram;
+}
+
+/**
+ * @brief Fallback for maps without introspection support: size and capacity only.
+ */
+template<typename Hashmap>
+TableStats Introspect(const Hashmap& map) {
+    TableStats stats;
+    stats.size = map.size();
+    if constexpr (requires { map.bucket_count(); }) {
+        stats.capacity = map.bucket_count();
+    }
+    FinishStats(stats);
+    return stats;
+}
+
+/**
+ * @brief std::unordered_map: position of each key in its bucket chain.
+ */
+template<typename K, typename V, typename H, typename E, typename A>
+TableStats Introspect(const std::unordered_map<K, V, H, E, A>& map) {
+    TableStats stats;
+    stats.size = map.size();
+    stats.capacity = map.bucket_count();
+    stats.probe_unit = "chain nodes";
+    stats.occupancy_unit = "bucket";
+    stats.occupancy_histogram.assign(1, 0);
+    for (size_t bucket = 0; bucket < map.bucket_count(); ++bucket) {
+        size_t position = 0;
+        for (auto it = map.begin(bucket); it != map.end(bucket); ++it) {
+            AddProbe(stats, position++);
+        }
+        if (stats.occupancy_histogram.size() <= position) stats.occupancy_histogram.resize(position + 1);
+        stats.occupancy_histogram[position]++;
+    }
+    FinishStats(stats);
+    return stats;
+}
+
+/**
+ * @brief absl::flat_hash_map: extra groups (and H2 false positives) per key.
+ */
+template<typename K, typename V, typename H, typename E, typename A>
+TableStats Introspect(const absl::flat_hash_map<K, V, H, E, A>& map) {
+    TableStats stats;
+    stats.size = map.size();
+    stats.capacity = map.bucket_count();
+    stats.probe_unit = "groups";
+    stats.occupancy_unit = "64B line";
+    for (const auto& entry : map) {
+        AddProbe(stats, absl::container_internal::GetHashtableDebugNumProbes(map, entry.first));
+    }
+    stats.occupancy_histogram = LineOccupancy(map, stats.capacity);
+    FinishStats(stats);
+    return stats;
+}
+
+/**
+ * @brief phmap::flat_hash_map: same hook as absl, in phmap's namespace.
+ */
+template<typename K, typename V, typename H, typename E, typename A>
+TableStats Introspect(const phmap::flat_hash_map<K, V, H, E, A>& map) {
+    using Access = phmap::priv::hashtable_debug_internal::HashtableDebugAccess<phmap::flat_hash_map<K, V, H, E, A>>;
+    TableStats stats;
+    stats.size = map.size();
+    stats.capacity = map.bucket_count();
+    stats.probe_unit = "groups";
+    stats.occupancy_unit = "64B line";
+    for (const auto& entry : map) {
+        AddProbe(stats, Access::GetNumProbes(map, entry.first));
+    }
+    stats.occupancy_histogram = LineOccupancy(map, stats.capacity);
+    FinishStats(stats);
+    return stats;
+}
+
+// robin_hood keeps its probe distances in private members (one info byte per
+// slot). Explicit template instantiation may name private members, which
+// gives read-only access to them without patching the library.
+template<typename Tag, typename Tag::type Member>
+struct PrivateMember {
+    friend typename Tag::type Get(Tag) { return Member; }
+};
+
+using RobinHoodIntMap = robin_hood::unordered_map<int, int>;
+struct RobinHoodInfo { using type = uint8_t* RobinHoodIntMap::*; friend type Get(RobinHoodInfo); };
+struct RobinHoodInfoInc { using type = uint32_t RobinHoodIntMap::*; friend type Get(RobinHoodInfoInc); };
+template struct PrivateMember<RobinHoodInfo, &RobinHoodIntMap::mInfo>;
+template struct PrivateMember<RobinHoodInfoInc, &RobinHoodIntMap::mInfoInc>;
+
+/**
+ * @brief robin_hood::unordered_map<int, int>: distance of each entry from its home slot.
+ *
+ * An occupied info byte holds (distance + 1) * mInfoInc plus some hash bits
+ * below mInfoInc; an empty slot is 0.
+ */
+inline TableStats Introspect(const RobinHoodIntMap& map) {
+    TableStats stats;
+    stats.size = map.size();
+    stats.capacity = map.size() ? map.mask() + 1 : 0;
+    stats.probe_unit = "slots";
+    stats.occupancy_unit = "64B line";
+
+    const uint8_t* info = map.*Get(RobinHoodInfo{});
+    const uint32_t info_inc = map.*Get(RobinHoodInfoInc{});
+    for (size_t slot = 0, found = 0; found < map.size(); ++slot) {
+        if (info[slot] == 0) continue;
+        AddProbe(stats, info[slot] / info_inc - 1);
+        ++found;
+    }
+    stats.occupancy_histogram = LineOccupancy(map, stats.capacity);
+    FinishStats(stats);
+    return stats;
+}
+
+/**
+ * @brief SparseHashMap: distance of each entry from its home slot.
+ *
+ * Occupancy is per 64-slot group; the packed entry arrays have no empty
+ * slots, so per-line occupancy would say nothing about the layout.
+ */
+template<typename K, typename V, typename H, typename E>
+TableStats Introspect(const SparseHashMap<K, V, H, E>& map) {
+    TableStats stats;
+    stats.size = map.size();
+    stats.capacity = map.bucket_count();
+    stats.probe_unit = "slots";
+    stats.occupancy_unit = "64-slot group";
+    for (const auto& entry : map) {
+        AddProbe(stats, map.num_probes(entry.first));
+    }
+    stats.occupancy_histogram = map.group_occupancy();
+    FinishStats(stats);
+    return stats;
+}
+
+/**
+ * @brief Writes a histogram as a JSON array.
+ */
+inline void WriteJsonArray(std::ostream& out, const std::vector<size_t>& values) {
+    out << '[';
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << (i ? ", " : "") << values[i];
+    }
+    out << ']';
+}
+
+/**
+ * @brief Writes @p stats as a JSON object (without trailing newline).
+ */
+inline void WriteJson(std::ostream& out, const TableStats& stats) {
+    out << "{\"size\": " << stats.size
+        << ", \"capacity\": " << stats.capacity
+        << ", \"load_factor\": " << stats.load_factor
+        << ", \"avg_probe\": " << stats.avg_probe
+        << ", \"max_probe\": " << stats.max_probe
+        << ", \"probe_unit\": \"" << stats.probe_unit << "\""
+        << ", \"probe_histogram\": ";
+    WriteJsonArray(out, stats.probe_histogram);
+    out << ", \"occupancy_unit\": \"" << stats.occupancy_unit << "\""
+        << ", \"occupancy_histogram\": ";
+    WriteJsonArray(out, stats.occupancy_histogram);
+    out << '}';
+}
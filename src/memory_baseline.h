@@ -0,0 +1,119 @@
+/**
+ * @file memory_baseline.h
+ * @brief Raw memory-system baselines used to normalize hashmap results.
+ *
+ * Provides a random pointer chase (the latency floor of a working set) and
+ * sequential read/write kernels (streaming bandwidth). A dependent hashmap
+ * lookup can never be faster than one dependent load from a working set of
+ * the same size, so the pointer chase is the natural unit for BM_RandomAccess.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * @brief One cache line of a pointer-chase ring.
+ */
+struct alignas(64) ChaseLine {
+    ChaseLine* next;
+    char padding[64 - sizeof(ChaseLine*)];
+};
+
+/**
+ * @brief Builds a ring of cache lines covering @p bytes in a random cyclic order.
+ *
+ * Sattolo's algorithm produces a single cycle through all lines, so a chase
+ * visits the whole working set before repeating and the hardware prefetcher
+ * cannot guess the next address.
+ */
+inline std::vector<ChaseLine> BuildChaseRing(size_t bytes, uint32_t seed = 42) {
+    const size_t lines = std::max<size_t>(2, bytes / sizeof(ChaseLine));
+    std::vector<ChaseLine> ring(lines);
+    std::vector<size_t> order(lines);
+    std::iota(order.begin(), order.end(), 0);
+
+    std::mt19937_64 gen(seed);
+    for (size_t i = lines - 1; i > 0; --i) {
+        std::uniform_int_distribution<size_t> dis(0, i - 1);
+        std::swap(order[i], order[dis(gen)]);
+    }
+    for (size_t i = 0; i < lines; ++i) {
+        ring[order[i]].next = &ring[order[(i + 1) % lines]];
+    }
+    return ring;
+}
+
+/**
+ * @brief Follows @p hops links starting at @p start.
+ * @return The line reached, so the caller can keep the chain alive.
+ */
+inline const ChaseLine* Chase(const ChaseLine* start, size_t hops) {
+    const ChaseLine* p = start;
+    for (size_t i = 0; i < hops; ++i) {
+        p = p->next;
+    }
+    return p;
+}
+
+/**
+ * @brief Average latency of one dependent load from a working set of @p bytes.
+ *
+ * Measured once per size and cached, so benchmarks can ask for it before
+ * every run without paying for it more than once.
+ */
+inline double MemoryLatencyFloorNs(size_t bytes) {
+    static std::mutex mutex;
+    static std::map<size_t, double> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(bytes);
+    if (it != cache.end()) return it->second;
+
+    constexpr size_t kHops = size_t{1} << 21;
+    const auto ring = BuildChaseRing(bytes);
+    // One warm-up lap (bounded) so the small sizes are measured from cache.
+    const ChaseLine* p = Chase(ring.data(), std::min(ring.size(), kHops));
+
+    const auto start = std::chrono::steady_clock::now();
+    p = Chase(p, kHops);
+    const auto stop = std::chrono::steady_clock::now();
+
+    benchmark::DoNotOptimize(p);
+
+    const double ns = std::chrono::duration<double, std::nano>(stop - start).count() / kHops;
+    cache.emplace(bytes, ns);
+    return ns;
+}
+
+/**
+ * @brief Sums a buffer with several independent accumulators (streaming read).
+ */
+inline uint64_t SequentialRead(const std::vector<uint64_t>& buffer) {
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= buffer.size(); i += 4) {
+        s0 += buffer[i];
+        s1 += buffer[i + 1];
+        s2 += buffer[i + 2];
+        s3 += buffer[i + 3];
+    }
+    for (; i < buffer.size(); ++i) s0 += buffer[i];
+    return s0 + s1 + s2 + s3;
+}
+
+/**
+ * @brief Overwrites a buffer from front to back (streaming write).
+ */
+inline void SequentialWrite(std::vector<uint64_t>& buffer, uint64_t value) {
+    std::fill(buffer.begin(), buffer.end(), value);
+}
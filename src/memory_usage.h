@@ -0,0 +1,125 @@
+/**
+ * @file memory_usage.h
+ * @brief Heap accounting helpers used to report table footprints.
+ *
+ * On glibc the allocator statistics (mallinfo2) give the exact number of
+ * bytes a container allocated. Elsewhere the footprint is estimated from
+ * the container's capacity.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#if defined(__linux__)
+#include <fstream>
+#include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+#define BENCH_HAVE_MALLINFO2 1
+#endif
+#endif
+
+/**
+ * @brief Bytes currently handed out by the heap to this process.
+ * @return Allocated bytes, or 0 if the platform cannot report it cheaply.
+ */
+inline size_t HeapBytesInUse() {
+#if defined(BENCH_HAVE_MALLINFO2)
+    const struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Estimates a container's heap footprint from its capacity.
+ *
+ * Used when HeapBytesInUse() is unavailable. Containers that know their
+ * own footprint expose allocated_bytes(); for the others this assumes one
+ * slot of value_type plus one byte of metadata per bucket, which is close
+ * for the flat maps and an underestimate for node-based maps.
+ */
+template<typename Hashmap>
+size_t ApproxTableBytes(const Hashmap& map) {
+    if constexpr (requires { map.allocated_bytes(); }) {
+        return map.allocated_bytes();
+    } else {
+        size_t buckets = 0;
+        if constexpr (requires { map.bucket_count(); }) {
+            buckets = map.bucket_count();
+        } else if constexpr (requires { map.mask(); }) {
+            buckets = map.mask() + 1;
+        } else {
+            buckets = map.size();
+        }
+        return buckets * (sizeof(typename Hashmap::value_type) + 1);
+    }
+}
+
+/**
+ * @brief Runs @p fill on @p map and returns the heap bytes it allocated.
+ *
+ * @param map Container to populate; it stays alive with its contents.
+ * @param fill Callable that populates the container.
+ * @return Bytes allocated by @p fill, or ApproxTableBytes() on platforms
+ *         without heap statistics.
+ */
+template<typename Hashmap, typename Fill>
+size_t BuildAndMeasure(Hashmap& map, Fill&& fill) {
+    const size_t before = HeapBytesInUse();
+    fill();
+    const size_t after = HeapBytesInUse();
+    if (after > before) return after - before;
+    return ApproxTableBytes(map);
+}
+
+/**
+ * @brief Allocator-wide statistics, for tracking fragmentation over time.
+ */
+struct HeapStats {
+    size_t in_use = 0;  ///< Bytes handed out, including mmap'd chunks.
+    size_t free = 0;    ///< Free bytes the allocator keeps in its arenas (fragmentation and cache).
+    size_t mapped = 0;  ///< Bytes of large allocations served by their own mmap.
+};
+
+/**
+ * @brief Current allocator statistics; all zero if the platform cannot report them.
+ */
+inline HeapStats ReadHeapStats() {
+    HeapStats stats;
+#if defined(BENCH_HAVE_MALLINFO2)
+    const struct mallinfo2 info = mallinfo2();
+    stats.in_use = info.uordblks + info.hblkhd;
+    stats.free = info.fordblks;
+    stats.mapped = info.hblkhd;
+#endif
+    return stats;
+}
+
+/**
+ * @brief Resident set size of this process, or 0 where /proc/self/statm is unavailable.
+ */
+inline size_t ResidentBytes() {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Hands free heap memory back to the OS where the allocator supports it (glibc).
+ */
+inline void ReleaseFreeHeap() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
@@ -0,0 +1,174 @@
+/**
+ * @file rcu_map.h
+ * @brief Read-mostly concurrent map: readers use immutable snapshots, writers publish copies.
+ *
+ * RcuMap<Map> holds a pointer to an immutable Map. A reader pins the current
+ * epoch, loads the pointer and runs its lookup on that snapshot: two atomic
+ * stores and two loads, no locks, no retries, so reads are wait-free and
+ * never contend with each other. A writer (serialized by a mutex) copies the
+ * current Map, applies its change to the copy and swaps the pointer in; the
+ * old snapshot is freed once no reader can still be using it.
+ *
+ *     RcuMap<absl::flat_hash_map<int, int>> map;
+ *     map.update([](auto& m) { m[1] = 10; });
+ *     int v = map.read([](const auto& m) { return m.at(1); });
+ *
+ * Reclamation is epoch based (EpochDomain): a snapshot retired at epoch E
+ * is freed when every thread that is inside read() entered at epoch >= E.
+ * Every update copies the whole map, so this suits tables that are updated
+ * rarely; batch changes into one update() where possible.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Process-wide epoch counter and one announcement slot per reading thread.
+ *
+ * A thread claims a slot the first time it reads and gives it back when it
+ * exits. Reads must not nest.
+ */
+class EpochDomain {
+public:
+    static constexpr size_t kMaxThreads = 256;
+    static constexpr uint64_t kIdle = std::numeric_limits<uint64_t>::max();
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    /// Announces that the calling thread reads from now on, at the current epoch.
+    void enter() { local_slot().epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst); }
+    /// Announces that the calling thread holds no snapshot any more.
+    void exit() { local_slot().epoch.store(kIdle, std::memory_order_release); }
+
+    /// Starts a new epoch and returns it.
+    uint64_t advance() { return epoch_.fetch_add(1, std::memory_order_seq_cst) + 1; }
+
+    /// Smallest epoch any thread is reading at, or kIdle if none is reading.
+    uint64_t min_active() const {
+        uint64_t min = kIdle;
+        for (const Slot& slot : slots_) {
+            const uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+            if (epoch < min) min = epoch;
+        }
+        return min;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{kIdle};
+        std::atomic<bool> claimed{false};
+    };
+
+    /// Claims a free slot for the lifetime of a thread.
+    struct SlotHandle {
+        Slot* slot = nullptr;
+
+        explicit SlotHandle(EpochDomain& domain) {
+            for (Slot& candidate : domain.slots_) {
+                bool expected = false;
+                if (candidate.claimed.compare_exchange_strong(expected, true)) {
+                    slot = &candidate;
+                    return;
+                }
+            }
+            throw std::runtime_error("EpochDomain: more than kMaxThreads reading threads");
+        }
+        ~SlotHandle() {
+            slot->epoch.store(kIdle, std::memory_order_release);
+            slot->claimed.store(false, std::memory_order_release);
+        }
+    };
+
+    Slot& local_slot() {
+        thread_local SlotHandle handle(*this);
+        return *handle.slot;
+    }
+
+    std::atomic<uint64_t> epoch_{1};
+    Slot slots_[kMaxThreads];
+};
+
+template<typename Map>
+class RcuMap {
+public:
+    explicit RcuMap(Map initial = Map()) : current_(new Map(std::move(initial))) {}
+    RcuMap(const RcuMap&) = delete;
+    RcuMap& operator=(const RcuMap&) = delete;
+
+    /// No reader may be inside read() when the map is destroyed.
+    ~RcuMap() {
+        delete current_.load();
+        for (Retired& retired : retired_) delete retired.map;
+    }
+
+    /**
+     * @brief Calls @p f with the current snapshot (const Map&) and returns its result.
+     *
+     * The snapshot stays valid until @p f returns; references into it must not escape.
+     */
+    template<typename F>
+    decltype(auto) read(F&& f) const {
+        EpochDomain& domain = EpochDomain::instance();
+        domain.enter();
+        struct Exit {
+            EpochDomain& domain;
+            ~Exit() { domain.exit(); }
+        } exit{domain};
+        return f(static_cast<const Map&>(*current_.load(std::memory_order_seq_cst)));
+    }
+
+    /**
+     * @brief Publishes a copy of the current snapshot after @p mutate (Map&) has changed it.
+     */
+    template<typename F>
+    void update(F&& mutate) {
+        std::lock_guard<std::mutex> lock(writer_);
+        auto next = std::make_unique<Map>(*current_.load(std::memory_order_relaxed));
+        mutate(*next);
+        Map* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        retired_.push_back({old, EpochDomain::instance().advance()});
+        reclaim();
+    }
+
+    /// Snapshots replaced but not yet freed (a reader may still be using them).
+    size_t retired() const {
+        std::lock_guard<std::mutex> lock(writer_);
+        return retired_.size();
+    }
+
+private:
+    struct Retired {
+        Map* map;
+        uint64_t epoch;  ///< First epoch at which no new reader can see the snapshot.
+    };
+
+    /// Frees every retired snapshot that no reader can still hold.
+    void reclaim() {
+        const uint64_t min_active = EpochDomain::instance().min_active();
+        size_t kept = 0;
+        for (Retired& retired : retired_) {
+            if (retired.epoch <= min_active) {
+                delete retired.map;
+            } else {
+                retired_[kept++] = retired;
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    std::atomic<Map*> current_;
+    mutable std::mutex writer_;
+    std::vector<Retired> retired_;
+};
@@ -0,0 +1,309 @@
+/**
+ * @file shm_hash_map.h
+ * @brief Fixed-capacity hash map in a POSIX shared memory segment: one writer, many reader processes.
+ *
+ * Worker processes that each build the same lookup table hold one copy per
+ * process. ShmHashMap keeps a single copy in a named segment (shm_open +
+ * mmap) that every process maps:
+ *
+ *     // writer
+ *     auto map = ShmHashMap<int, int>::create("/lookup", 1 << 20);
+ *     map.insert(1, 10);
+ *     // any other process
+ *     auto view = ShmHashMap<int, int>::open("/lookup");
+ *     const auto* entry = view.find(1);  // nullptr if absent
+ *
+ * The segment holds no pointers: a header records the offsets of the
+ * control bytes and of the slot array from the start of the segment, so it
+ * is valid at whatever address each process maps it. Keys and values must
+ * be trivially copyable, and the hash must give the same result in every
+ * process; the default StableHash does, while absl::Hash is seeded per
+ * process and std::hash is not guaranteed to be.
+ *
+ * Open addressing with linear probing. The capacity is fixed when the
+ * segment is created (there is no rehash, since readers hold mappings of the
+ * current size) and there is no erase. The writer may keep inserting while
+ * readers look up: an entry's slot is written before its control byte is
+ * set with release semantics, and readers load control bytes with acquire.
+ * Overwriting the value of a present key is not supported, as readers could
+ * see it half written.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Process-independent hash of a key's object representation (murmur3 finalizer per 8 bytes).
+ */
+template<typename Key>
+struct StableHash {
+    static_assert(std::has_unique_object_representations_v<Key>, "hashes the bytes of the key");
+
+    size_t operator()(const Key& key) const {
+        unsigned char bytes[sizeof(Key)];
+        std::memcpy(bytes, &key, sizeof(Key));
+        uint64_t hash = sizeof(Key);
+        for (size_t i = 0; i < sizeof(Key); i += 8) {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + i, std::min<size_t>(8, sizeof(Key) - i));
+            hash = Mix(hash ^ word);
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    static uint64_t Mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+template<typename Key, typename Value, typename Hash = StableHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ShmHashMap {
+public:
+    static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>,
+                  "entries are shared between processes as raw bytes");
+
+    /// Slot layout; a std::pair would not be trivially copyable.
+    struct Entry {
+        Key first;
+        Value second;
+    };
+
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = Entry;
+    using size_type = size_t;
+    using const_iterator = const Entry*;
+
+    /// Highest load the capacity is sized for.
+    static constexpr double kMaxLoad = 0.75;
+
+    /**
+     * @brief Creates segment @p name (which must not exist yet) with room for @p max_entries entries.
+     *
+     * The returned map is the writer and owns the name: it is unlinked when the
+     * map is destroyed. Processes that opened it keep their mappings.
+     * @throws std::system_error if the segment cannot be created or mapped.
+     */
+    static ShmHashMap create(const std::string& name, size_t max_entries) {
+        size_t capacity = kMinCapacity;
+        while (static_cast<double>(max_entries) > kMaxLoad * capacity) capacity *= 2;
+        const Layout layout = Layout::For(capacity);
+
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        // ftruncate extends with zero pages, so every control byte starts out kEmpty.
+        if (::ftruncate(fd, static_cast<off_t>(layout.bytes)) != 0) {
+            const int error = errno;
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+        }
+        void* base = ::mmap(nullptr, layout.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            ::shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(), "mmap " + name);
+        }
+
+        Header* header = ::new (base) Header{};
+        header->key_size = sizeof(Key);
+        header->value_size = sizeof(Value);
+        header->capacity = capacity;
+        header->ctrl_offset = layout.ctrl_offset;
+        header->slots_offset = layout.slots_offset;
+        header->bytes = layout.bytes;
+        header->magic.store(kMagic, std::memory_order_release);
+
+        ShmHashMap map(static_cast<unsigned char*>(base), layout.bytes, true);
+        map.name_ = name;
+        return map;
+    }
+
+    /**
+     * @brief Maps existing segment @p name read-only.
+     * @throws std::system_error if it cannot be opened, std::runtime_error if it is not a
+     *         ShmHashMap of this Key and Value.
+     */
+    static ShmHashMap open(const std::string& name) {
+        const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + name);
+        }
+        const size_t bytes = static_cast<size_t>(st.st_size);
+        if (bytes < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error("ShmHashMap: segment " + name + " is too small");
+        }
+        void* base = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (base == MAP_FAILED) throw std::system_error(error, std::generic_category(), "mmap " + name);
+
+        ShmHashMap map(static_cast<unsigned char*>(base), bytes, false);
+        const Header& header = map.header();
+        if (header.magic.load(std::memory_order_acquire) != kMagic || header.key_size != sizeof(Key) ||
+            header.value_size != sizeof(Value) || header.bytes != bytes || header.capacity == 0 ||
+            (header.capacity & (header.capacity - 1)) != 0 ||
+            Layout::For(header.capacity).bytes != bytes) {
+            throw std::runtime_error("ShmHashMap: segment " + name + " does not hold this map type");
+        }
+        return map;
+    }
+
+    /// Unlinks segment @p name if it exists, e.g. one left behind by a writer that crashed.
+    static void unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    /// A map attached to no segment; assign the result of create() or open() to it.
+    ShmHashMap() = default;
+    ShmHashMap(const ShmHashMap&) = delete;
+    ShmHashMap& operator=(const ShmHashMap&) = delete;
+    ShmHashMap(ShmHashMap&& other) noexcept { swap(other); }
+    ShmHashMap& operator=(ShmHashMap&& other) noexcept {
+        if (this != &other) {
+            ShmHashMap moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+    ~ShmHashMap() {
+        if (base_) ::munmap(base_, bytes_);
+        if (!name_.empty()) ::shm_unlink(name_.c_str());
+    }
+
+    /**
+     * @brief Adds @p key -> @p value unless @p key is present. Writer only.
+     * @return false if the key was already present (its value is left unchanged).
+     * @throws std::length_error when the map already holds the max_entries it was created for.
+     */
+    bool insert(const Key& key, const Value& value) {
+        if (!writable_) throw std::logic_error("ShmHashMap: insert on a read-only mapping");
+        const size_t mask = header().capacity - 1;
+        size_t i = hash_(key) & mask;
+        for (;; i = (i + 1) & mask) {
+            if (ctrl(i) == kEmpty) break;
+            if (equal_(slots()[i].first, key)) return false;
+        }
+        const size_t size = header().size.load(std::memory_order_relaxed);
+        if (static_cast<double>(size + 1) > kMaxLoad * header().capacity) {
+            throw std::length_error("ShmHashMap: segment is full");
+        }
+        Entry* slot = const_cast<Entry*>(slots()) + i;
+        slot->first = key;
+        slot->second = value;
+        std::atomic_ref<uint8_t>(base_[header().ctrl_offset + i]).store(kFull, std::memory_order_release);
+        header().size.store(size + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief The entry of @p key, or nullptr (end()) if absent.
+     */
+    const Entry* find(const Key& key) const {
+        const size_t mask = header().capacity - 1;
+        for (size_t i = hash_(key) & mask;; i = (i + 1) & mask) {
+            if (ctrl(i) == kEmpty) return nullptr;
+            if (equal_(slots()[i].first, key)) return &slots()[i];
+        }
+    }
+
+    size_t count(const Key& key) const { return find(key) != nullptr; }
+    const_iterator end() const { return nullptr; }
+
+    size_t size() const { return header().size.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    size_t bucket_count() const { return header().capacity; }
+    /// Entries the segment was sized for.
+    size_t max_entries() const { return static_cast<size_t>(kMaxLoad * header().capacity); }
+    /// Bytes of the mapped segment (shared memory, not heap), header included.
+    size_t allocated_bytes() const { return bytes_; }
+    /// True for the creating process.
+    bool writable() const { return writable_; }
+
+    void swap(ShmHashMap& other) noexcept {
+        std::swap(base_, other.base_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(writable_, other.writable_);
+        std::swap(name_, other.name_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+private:
+    static constexpr uint64_t kMagic = 0x50414d4853534e43ULL;
+    static constexpr size_t kMinCapacity = 16;
+    static constexpr size_t kLine = 64;
+
+    enum : uint8_t { kEmpty = 0, kFull = 1 };
+
+    /// Start of the segment. Everything else is addressed by offset from here.
+    struct Header {
+        std::atomic<uint64_t> magic{0};  ///< Set last by the writer: the header is complete.
+        uint32_t key_size = 0;
+        uint32_t value_size = 0;
+        uint64_t capacity = 0;
+        uint64_t ctrl_offset = 0;
+        uint64_t slots_offset = 0;
+        uint64_t bytes = 0;
+        std::atomic<uint64_t> size{0};
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "header atomics are shared between processes");
+    static_assert(alignof(Entry) <= kLine, "slots are cache-line aligned in the segment");
+
+    struct Layout {
+        size_t ctrl_offset;
+        size_t slots_offset;
+        size_t bytes;
+
+        static size_t RoundUp(size_t n) { return (n + kLine - 1) / kLine * kLine; }
+        static Layout For(size_t capacity) {
+            Layout layout;
+            layout.ctrl_offset = RoundUp(sizeof(Header));
+            layout.slots_offset = RoundUp(layout.ctrl_offset + capacity);
+            layout.bytes = layout.slots_offset + capacity * sizeof(Entry);
+            return layout;
+        }
+    };
+
+    ShmHashMap(unsigned char* base, size_t bytes, bool writable) : base_(base), bytes_(bytes), writable_(writable) {}
+
+    Header& header() const { return *reinterpret_cast<Header*>(base_); }
+    const Entry* slots() const { return reinterpret_cast<const Entry*>(base_ + header().slots_offset); }
+    /// Acquire load of control byte @p i. A byte load does not write, so it works on a read-only mapping.
+    uint8_t ctrl(size_t i) const {
+        return std::atomic_ref<uint8_t>(base_[header().ctrl_offset + i]).load(std::memory_order_acquire);
+    }
+
+    unsigned char* base_ = nullptr;
+    size_t bytes_ = 0;
+    bool writable_ = false;
+    std::string name_;  ///< Set for the creating side only, which unlinks it.
+    Hash hash_;
+    KeyEqual equal_;
+};
@@ -0,0 +1,252 @@
+/**
+ * @file shm_map_benchmarks.cpp
+ * @brief One lookup table for N worker processes: a shared memory segment vs a private copy in each.
+ *
+ * Every iteration forks `processes` workers that each look up all N keys of
+ * the table once, in random order, so every page of the table is touched.
+ * The table comes from:
+ * - BM_SharedTable: the parent builds one ShmHashMap (shm_hash_map.h) and
+ *   every worker maps it read-only.
+ * - BM_PrivateTables<Hashmap>: every worker builds its own Hashmap from the
+ *   keys, as independent workers do without a shared table.
+ *
+ * Each worker reports the private memory it gained (Private_Clean +
+ * Private_Dirty from /proc/self/smaps_rollup; pages of the segment are
+ * mapped by the parent too, so they count as shared) and its lookup time.
+ * Counters:
+ * - `lookup_ns`: mean lookup time in the workers.
+ * - `private_bytes_per_process`: private memory per worker, i.e. its own table.
+ * - `total_bytes`: what the table costs across all processes (every worker's
+ *   private bytes, plus the segment once).
+ * - `bytes_saved` (BM_SharedTable): against every worker holding its own
+ *   absl::flat_hash_map, whose size is measured in the parent.
+ *
+ * Wall time per iteration covers building, starting the workers and their
+ * lookups. In-process lookup latency of ShmHashMap next to the other maps is
+ * in random_access_benchmarks (ShmReaderTable). Linux only.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "shm_hash_map.h"
+#include "benchmark_data.h"
+#include "memory_usage.h"
+
+/**
+ * @brief What a worker process sends back to the parent.
+ */
+struct WorkerReport {
+    double lookup_ns = 0;
+    int64_t private_bytes = 0;
+    int64_t checksum = 0;
+};
+
+/**
+ * @brief Private (unshared) resident bytes of this process.
+ */
+static int64_t PrivateBytes() {
+    // smaps_rollup needs Linux 4.14; summing the per-mapping smaps gives the same total.
+    for (const char* path : {"/proc/self/smaps_rollup", "/proc/self/smaps"}) {
+        std::ifstream in(path);
+        if (!in) continue;
+        int64_t kb = 0;
+        std::string line;
+        while (std::getline(in, line)) {
+            for (const char* field : {"Private_Clean:", "Private_Dirty:"}) {
+                if (line.compare(0, std::strlen(field), field) == 0) {
+                    kb += std::strtoll(line.c_str() + std::strlen(field), nullptr, 10);
+                }
+            }
+        }
+        return kb * 1024;
+    }
+    return 0;
+}
+
+/**
+ * @brief Looks up every key of @p lookups once with @p find (key -> value), timed.
+ */
+template<typename Find>
+static WorkerReport LookupAll(const std::vector<int>& lookups, Find&& find) {
+    const auto start = std::chrono::steady_clock::now();
+    WorkerReport report;
+    for (int key : lookups) report.checksum += find(key);
+    const auto stop = std::chrono::steady_clock::now();
+    report.lookup_ns = std::chrono::duration<double, std::nano>(stop - start).count() / lookups.size();
+    return report;
+}
+
+/**
+ * @brief Forks @p processes workers running @p worker (returning a WorkerReport) and collects their reports.
+ * @return false if a worker could not be started or failed.
+ */
+template<typename Worker>
+static bool RunWorkers(size_t processes, Worker&& worker, std::vector<WorkerReport>& reports) {
+    int fds[2];
+    if (::pipe(fds) != 0) return false;
+    std::vector<pid_t> pids;
+    for (size_t p = 0; p < processes; ++p) {
+        const pid_t pid = ::fork();
+        if (pid < 0) break;
+        if (pid == 0) {
+            ::close(fds[0]);
+            int status = 1;
+            try {
+                const WorkerReport report = worker();
+                // Reports are smaller than PIPE_BUF, so the writes of different workers do not interleave.
+                if (::write(fds[1], &report, sizeof(report)) == static_cast<ssize_t>(sizeof(report))) status = 0;
+            } catch (...) {
+            }
+            // _exit: the child must not run the parent's atexit handlers or flush its stdio buffers.
+            ::_exit(status);
+        }
+        pids.push_back(pid);
+    }
+    ::close(fds[1]);
+
+    reports.clear();
+    WorkerReport report;
+    while (::read(fds[0], &report, sizeof(report)) == static_cast<ssize_t>(sizeof(report))) {
+        reports.push_back(report);
+    }
+    ::close(fds[0]);
+
+    bool ok = pids.size() == processes;
+    for (pid_t pid : pids) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return ok && reports.size() == processes;
+}
+
+static std::vector<int> Shuffled(std::vector<int> keys) {
+    std::mt19937 gen(123);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    return keys;
+}
+
+static void ReportWorkers(benchmark::State& state, const std::vector<WorkerReport>& reports, size_t shared_bytes) {
+    double lookup_ns = 0;
+    int64_t private_bytes = 0;
+    for (const WorkerReport& report : reports) {
+        lookup_ns += report.lookup_ns;
+        private_bytes += report.private_bytes;
+    }
+    state.counters["lookup_ns"] = lookup_ns / reports.size();
+    state.counters["private_bytes_per_process"] = static_cast<double>(private_bytes) / reports.size();
+    state.counters["total_bytes"] = static_cast<double>(private_bytes + static_cast<int64_t>(shared_bytes));
+}
+
+/**
+ * @brief One ShmHashMap built by the parent, mapped read-only by every worker.
+ * Arguments: range(0) = worker processes, range(1) = N keys.
+ */
+static void BM_SharedTable(benchmark::State& state) {
+    const size_t processes = state.range(0);
+    const std::vector<int> keys = GenerateDistinctEvenKeys(state.range(1), 42);
+    const std::vector<int> lookups = Shuffled(keys);
+
+    // Footprint of the private copy every worker would otherwise build.
+    size_t private_table_bytes = 0;
+    {
+        absl::flat_hash_map<int, int> map;
+        private_table_bytes = BuildAndMeasure(map, [&] {
+            map.reserve(keys.size());
+            for (int key : keys) map[key] = key;
+        });
+    }
+
+    const std::string prefix = "/shm_benchmarks." + std::to_string(::getpid()) + ".";
+    std::vector<WorkerReport> reports;
+    size_t segment_bytes = 0;
+    int64_t iteration = 0;
+    for (auto _ : state) {
+        const std::string name = prefix + std::to_string(iteration++);
+        auto table = ShmHashMap<int, int>::create(name, keys.size());
+        for (int key : keys) table.insert(key, key);
+        segment_bytes = table.allocated_bytes();
+
+        const bool ok = RunWorkers(processes, [&] {
+            const int64_t before = PrivateBytes();
+            const auto view = ShmHashMap<int, int>::open(name);
+            WorkerReport report = LookupAll(lookups, [&](int key) { return view.find(key)->second; });
+            report.private_bytes = PrivateBytes() - before;
+            return report;
+        }, reports);
+        if (!ok) {
+            state.SkipWithError("worker process failed");
+            return;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * processes * lookups.size());
+    ReportWorkers(state, reports, segment_bytes);
+    state.counters["bytes_saved"] =
+        static_cast<double>(processes * private_table_bytes) - state.counters["total_bytes"].value;
+}
+
+/**
+ * @brief Every worker builds and queries its own Hashmap.
+ * Arguments: range(0) = worker processes, range(1) = N keys.
+ */
+template<typename Hashmap>
+static void BM_PrivateTables(benchmark::State& state) {
+    const size_t processes = state.range(0);
+    const std::vector<int> keys = GenerateDistinctEvenKeys(state.range(1), 42);
+    const std::vector<int> lookups = Shuffled(keys);
+
+    std::vector<WorkerReport> reports;
+    for (auto _ : state) {
+        const bool ok = RunWorkers(processes, [&] {
+            const int64_t before = PrivateBytes();
+            Hashmap map;
+            map.reserve(keys.size());
+            for (int key : keys) map[key] = key;
+            WorkerReport report = LookupAll(lookups, [&](int key) { return map.find(key)->second; });
+            report.private_bytes = PrivateBytes() - before;
+            return report;
+        }, reports);
+        if (!ok) {
+            state.SkipWithError("worker process failed");
+            return;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * processes * lookups.size());
+    ReportWorkers(state, reports, 0);
+}
+
+/**
+ * @brief 1 to 8 workers over tables of 64K and 1M keys.
+ */
+static void ProcessArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"processes", "N"});
+    for (int64_t n : {int64_t{1} << 16, int64_t{1} << 20}) {
+        for (int64_t processes : {1, 2, 4, 8}) bench->Args({processes, n});
+    }
+    bench->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+// Register benchmarks
+BENCHMARK(BM_SharedTable)->Apply(ProcessArgs);
+BENCHMARK_TEMPLATE(BM_PrivateTables, std::unordered_map<int, int>)->Apply(ProcessArgs);
+BENCHMARK_TEMPLATE(BM_PrivateTables, absl::flat_hash_map<int, int>)->Apply(ProcessArgs);
+BENCHMARK_TEMPLATE(BM_PrivateTables, robin_hood::unordered_map<int, int>)->Apply(ProcessArgs);
+BENCHMARK_TEMPLATE(BM_PrivateTables, phmap::flat_hash_map<int, int>)->Apply(ProcessArgs);
+
+BENCHMARK_MAIN();
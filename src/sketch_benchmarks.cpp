@@ -0,0 +1,207 @@
+/**
+ * @file sketch_benchmarks.cpp
+ * @brief Approximate heavy-hitter counting vs exact counting with each map.
+ *
+ * Every engine consumes the streams of BM_HistogramSort (N values with a
+ * controlled number of distinct keys), optionally with Zipf-skewed key
+ * frequencies, and answers "what are the top-K keys and their counts":
+ * - BM_ExactTopK: count everything in a map, then select the top K.
+ * - BM_CountMin: Count-Min sketch with conservative update (count_min_sketch.h).
+ * - BM_SpaceSaving: Space-Saving summary (space_saving.h).
+ *
+ * Counters:
+ * - items_per_second: stream throughput.
+ * - bytes: heap footprint of the counting structure.
+ * - topk_error: mean relative count error over the true top-K keys.
+ * - topk_recall: share of the true top-K keys reported (Space-Saving only;
+ *   a Count-Min sketch answers point queries and cannot list keys).
+ *
+ * On uniform streams (skew 0) the top-K is decided by sampling noise, so
+ * recall there mostly shows that no heavy hitters exist.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "compact_counter_map.h"
+#include "count_min_sketch.h"
+#include "space_saving.h"
+#include "benchmark_data.h"
+#include "memory_usage.h"
+
+// Number of heavy hitters every engine is asked for.
+static constexpr size_t kTopK = 16;
+
+/**
+ * @brief Stream of range(0) values over range(1) keys with Zipf exponent range(2) / 100.
+ *
+ * Skew 0 is exactly the BM_HistogramSort input.
+ */
+static std::vector<int> MakeStream(const benchmark::State& state) {
+    if (state.range(2) == 0) return GenerateRandomData(state.range(0), state.range(1));
+    return GenerateZipfData(state.range(0), state.range(1), state.range(2) / 100.0);
+}
+
+/**
+ * @brief The @p k keys with the highest counts, highest first.
+ */
+template<typename Counts>
+std::vector<std::pair<int, int64_t>> SelectTopK(const Counts& counts, size_t k) {
+    std::vector<std::pair<int, int64_t>> all;
+    all.reserve(counts.size());
+    for (const auto& [key, count] : counts) all.emplace_back(key, static_cast<int64_t>(count));
+    const size_t n = std::min(k, all.size());
+    std::partial_sort(all.begin(), all.begin() + n, all.end(),
+                      [](const auto& a, const auto& b) { return a.second > b.second; });
+    all.resize(n);
+    return all;
+}
+
+/**
+ * @brief Exact top-K of a stream, the reference for the accuracy counters.
+ */
+static std::vector<std::pair<int, int64_t>> TrueTopK(const std::vector<int>& stream) {
+    absl::flat_hash_map<int, int64_t> counts;
+    for (int val : stream) counts[val]++;
+    return SelectTopK(counts, kTopK);
+}
+
+/**
+ * @brief Mean |estimate - true| / true over the true top-K keys.
+ */
+template<typename Estimate>
+double TopKError(const std::vector<std::pair<int, int64_t>>& truth, Estimate&& estimate) {
+    double error = 0;
+    for (const auto& [key, count] : truth) {
+        error += std::abs(static_cast<double>(estimate(key)) - count) / count;
+    }
+    return truth.empty() ? 0.0 : error / truth.size();
+}
+
+/**
+ * @brief Exact counting in a map, then top-K selection.
+ * Arguments: range(0) = N, range(1) = distinct keys, range(2) = skew.
+ */
+template<typename Hashmap>
+static void BM_ExactTopK(benchmark::State& state) {
+    const auto stream = MakeStream(state);
+
+    for (auto _ : state) {
+        Hashmap counts;
+        for (int val : stream) counts[val]++;
+        auto top = SelectTopK(counts, kTopK);
+        benchmark::DoNotOptimize(top);
+    }
+    state.SetItemsProcessed(state.iterations() * stream.size());
+
+    Hashmap counts;
+    state.counters["bytes"] = static_cast<double>(BuildAndMeasure(counts, [&] {
+        for (int val : stream) counts[val]++;
+    }));
+    state.counters["topk_error"] = 0;
+    state.counters["topk_recall"] = 1;
+}
+
+/**
+ * @brief Count-Min sketch of depth 4.
+ * Arguments: range(0) = N, range(1) = distinct keys, range(2) = skew, range(3) = width.
+ */
+static void BM_CountMin(benchmark::State& state) {
+    constexpr size_t kDepth = 4;
+    const auto stream = MakeStream(state);
+
+    for (auto _ : state) {
+        CountMinSketch<int> sketch(state.range(3), kDepth);
+        for (int val : stream) sketch.add(val);
+        benchmark::DoNotOptimize(sketch);
+    }
+    state.SetItemsProcessed(state.iterations() * stream.size());
+
+    CountMinSketch<int> sketch(state.range(3), kDepth);
+    for (int val : stream) sketch.add(val);
+    state.counters["bytes"] = static_cast<double>(sketch.allocated_bytes());
+    state.counters["topk_error"] = TopKError(TrueTopK(stream), [&](int key) { return sketch.estimate(key); });
+}
+
+/**
+ * @brief Space-Saving summary monitoring range(3) keys.
+ * Arguments: range(0) = N, range(1) = distinct keys, range(2) = skew, range(3) = capacity.
+ */
+static void BM_SpaceSaving(benchmark::State& state) {
+    const auto stream = MakeStream(state);
+
+    for (auto _ : state) {
+        SpaceSaving<int> summary(state.range(3));
+        for (int val : stream) summary.add(val);
+        auto top = summary.top(kTopK);
+        benchmark::DoNotOptimize(top);
+    }
+    state.SetItemsProcessed(state.iterations() * stream.size());
+
+    SpaceSaving<int> summary(state.range(3));
+    state.counters["bytes"] = static_cast<double>(BuildAndMeasure(summary, [&] {
+        for (int val : stream) summary.add(val);
+    }));
+
+    const auto truth = TrueTopK(stream);
+    absl::flat_hash_set<int> reported;
+    for (const auto& counter : summary.top(kTopK)) reported.insert(counter.key);
+    size_t hits = 0;
+    for (const auto& entry : truth) hits += reported.count(entry.first);
+    state.counters["topk_error"] = TopKError(truth, [&](int key) { return summary.estimate(key); });
+    state.counters["topk_recall"] = truth.empty() ? 1.0 : static_cast<double>(hits) / truth.size();
+}
+
+/**
+ * @brief N = 1M; distinct keys from 1K to 1M; uniform and Zipf(1.0) frequencies.
+ */
+static void ExactArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "distinct", "skew"});
+    for (int64_t distinct : {int64_t{1} << 10, int64_t{1} << 16, int64_t{1} << 20}) {
+        for (int64_t skew : {0, 100}) {
+            bench->Args({int64_t{1} << 20, distinct, skew});
+        }
+    }
+}
+
+static void CountMinArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "distinct", "skew", "width"});
+    for (int64_t distinct : {int64_t{1} << 10, int64_t{1} << 16, int64_t{1} << 20}) {
+        for (int64_t skew : {0, 100}) {
+            for (int64_t width : {int64_t{1} << 8, int64_t{1} << 12, int64_t{1} << 16}) {
+                bench->Args({int64_t{1} << 20, distinct, skew, width});
+            }
+        }
+    }
+}
+
+static void SpaceSavingArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "distinct", "skew", "capacity"});
+    for (int64_t distinct : {int64_t{1} << 10, int64_t{1} << 16, int64_t{1} << 20}) {
+        for (int64_t skew : {0, 100}) {
+            for (int64_t capacity : {int64_t{64}, int64_t{1} << 10, int64_t{1} << 14}) {
+                bench->Args({int64_t{1} << 20, distinct, skew, capacity});
+            }
+        }
+    }
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_ExactTopK, std::unordered_map<int, int>)->Apply(ExactArgs);
+BENCHMARK_TEMPLATE(BM_ExactTopK, absl::flat_hash_map<int, int>)->Apply(ExactArgs);
+BENCHMARK_TEMPLATE(BM_ExactTopK, robin_hood::unordered_map<int, int>)->Apply(ExactArgs);
+BENCHMARK_TEMPLATE(BM_ExactTopK, phmap::flat_hash_map<int, int>)->Apply(ExactArgs);
+BENCHMARK_TEMPLATE(BM_ExactTopK, CompactCounterMap<int, uint16_t>)->Apply(ExactArgs);
+
+BENCHMARK(BM_CountMin)->Apply(CountMinArgs);
+BENCHMARK(BM_SpaceSaving)->Apply(SpaceSavingArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+/**
+ * @file sliding_window_benchmarks.cpp
+ * @brief Rolling-window frequency counts: increment, decrement and erase at zero.
+ *
+ * A ring buffer holds the last `window` keys of a stream. Every arriving key
+ * is incremented in the map; the key leaving the window is decremented and
+ * erased when its count reaches zero. Inserts, updates and erases therefore
+ * happen at the same churn rate for as long as the run lasts, which is the
+ * pattern that exposes tombstone build-up and allocator drift.
+ *
+ * Each item is one arrival plus one departure. Memory is sampled every 64K
+ * items with the timer paused (heap bytes from mallinfo2, or the capacity
+ * estimate elsewhere):
+ * - bytes_warm: footprint once the first window is full.
+ * - bytes_peak / bytes_end: largest and last sample of the run.
+ * - bytes_drift: (bytes_end - bytes_warm) / bytes_warm; near 0 when stable.
+ *
+ * Run with a long --benchmark_min_time to check stability over long runs.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "benchmark_data.h"
+#include "memory_usage.h"
+
+// Length of the generated stream; the run wraps around at the end.
+static constexpr size_t kStreamLength = size_t{1} << 22;
+
+/**
+ * @brief Sliding-window counting with each contender.
+ * Arguments: range(0) = window length, range(1) = distinct keys, range(2) = skew (Zipf exponent x 100).
+ */
+template<typename Hashmap>
+static void BM_SlidingWindow(benchmark::State& state) {
+    const size_t window = state.range(0);
+    const std::vector<int> stream = state.range(2) == 0
+        ? GenerateRandomData(kStreamLength, state.range(1))
+        : GenerateZipfData(kStreamLength, state.range(1), state.range(2) / 100.0);
+    std::vector<int> ring(window);
+
+    const size_t heap_base = HeapBytesInUse();
+    Hashmap counts;
+    auto footprint = [&] {
+        const size_t heap = HeapBytesInUse();
+        if (heap == 0) return ApproxTableBytes(counts);
+        return heap > heap_base ? heap - heap_base : size_t{0};
+    };
+
+    size_t idx = 0;
+    for (size_t i = 0; i < window; ++i, ++idx) {
+        ring[i] = stream[idx];
+        counts[stream[idx]]++;
+    }
+    const size_t bytes_warm = footprint();
+    size_t bytes_peak = bytes_warm;
+
+    size_t pos = 0;
+    size_t erases = 0;
+    size_t items = 0;
+    for (auto _ : state) {
+        const int in = stream[idx];
+        const int out = ring[pos];
+        ring[pos] = in;
+        if (++pos == window) pos = 0;
+        if (++idx == stream.size()) idx = 0;
+
+        // Increment first, so a key that arrives as it leaves is never erased.
+        counts[in]++;
+        auto it = counts.find(out);
+        if (--it->second == 0) {
+            counts.erase(it);
+            ++erases;
+        }
+
+        if ((++items & 0xffff) == 0) {
+            // mallinfo2 walks every arena, so keep its cost out of the measured time.
+            state.PauseTiming();
+            bytes_peak = std::max(bytes_peak, footprint());
+            state.ResumeTiming();
+        }
+    }
+    const size_t bytes_end = footprint();
+    bytes_peak = std::max(bytes_peak, bytes_end);
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["live_keys"] = static_cast<double>(counts.size());
+    state.counters["erases_per_item"] = static_cast<double>(erases) / state.iterations();
+    state.counters["bytes_warm"] = static_cast<double>(bytes_warm);
+    state.counters["bytes_peak"] = static_cast<double>(bytes_peak);
+    state.counters["bytes_end"] = static_cast<double>(bytes_end);
+    state.counters["bytes_drift"] = bytes_warm ? (static_cast<double>(bytes_end) - bytes_warm) / bytes_warm : 0.0;
+}
+
+/**
+ * @brief Small and large windows, over key universes smaller and larger than
+ *        the window, with uniform and Zipf(1.0) popularity.
+ */
+static void WindowArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"window", "distinct", "skew"});
+    for (int64_t window : {int64_t{1} << 10, int64_t{1} << 16}) {
+        for (int64_t distinct : {int64_t{1} << 12, int64_t{1} << 20}) {
+            for (int64_t skew : {0, 100}) {
+                bench->Args({window, distinct, skew});
+            }
+        }
+    }
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_SlidingWindow, std::unordered_map<int, int>)->Apply(WindowArgs);
+BENCHMARK_TEMPLATE(BM_SlidingWindow, absl::flat_hash_map<int, int>)->Apply(WindowArgs);
+BENCHMARK_TEMPLATE(BM_SlidingWindow, robin_hood::unordered_map<int, int>)->Apply(WindowArgs);
+BENCHMARK_TEMPLATE(BM_SlidingWindow, phmap::flat_hash_map<int, int>)->Apply(WindowArgs);
+
+BENCHMARK_MAIN();
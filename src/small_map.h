@@ -0,0 +1,148 @@
+/**
+ * @file small_map.h
+ * @brief Map with inline storage for its first N entries, spilling to a hash index.
+ *
+ * Per-entity maps are mostly empty or tiny, so what they cost is the object
+ * itself plus the first allocation. SmallMap keeps up to N entries in a
+ * buffer inside the object and finds them by linear search, so an empty or
+ * small map never touches the heap:
+ *
+ *     | size | large_ | entry 0 | ... | entry N-1 |
+ *
+ * The (N+1)-th insert moves every entry to a heap vector and indexes it with
+ * an absl::flat_hash_map from key to position. Either way the entries are
+ * contiguous, so iterators are plain pointers. There is no erase.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "memory_usage.h"
+
+template<typename Key, typename Value, size_t N = 8,
+         typename Hash = absl::Hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class SmallMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    static constexpr size_t kInlineCapacity = N;
+
+    SmallMap() = default;
+    SmallMap(const SmallMap&) = delete;
+    SmallMap& operator=(const SmallMap&) = delete;
+    SmallMap(SmallMap&& other) noexcept { take(other); }
+    SmallMap& operator=(SmallMap&& other) noexcept {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+    ~SmallMap() { clear(); }
+
+    Value& operator[](const Key& key) {
+        if (iterator it = find(key); it != end()) return it->second;
+        if (!large_ && size_ < N) {
+            return (::new (inline_entry(size_++)) value_type(key, Value()))->second;
+        }
+        if (!large_) spill();
+        large_->index.emplace(key, static_cast<uint32_t>(large_->entries.size()));
+        return large_->entries.emplace_back(key, Value()).second;
+    }
+
+    iterator find(const Key& key) {
+        return const_cast<iterator>(std::as_const(*this).find(key));
+    }
+
+    const_iterator find(const Key& key) const {
+        if (large_) {
+            auto it = large_->index.find(key);
+            return it == large_->index.end() ? end() : &large_->entries[it->second];
+        }
+        for (const_iterator it = begin(); it != end(); ++it) {
+            if (KeyEqual()(it->first, key)) return it;
+        }
+        return end();
+    }
+
+    size_t count(const Key& key) const { return find(key) != end(); }
+
+    iterator begin() { return large_ ? large_->entries.data() : inline_entry(0); }
+    iterator end() { return begin() + size(); }
+    const_iterator begin() const { return large_ ? large_->entries.data() : inline_entry(0); }
+    const_iterator end() const { return begin() + size(); }
+
+    size_t size() const { return large_ ? large_->entries.size() : size_; }
+    bool empty() const { return size() == 0; }
+    /// True once the map has outgrown its inline buffer.
+    bool is_large() const { return large_ != nullptr; }
+    /// Heap bytes; zero while the entries fit inline.
+    size_t allocated_bytes() const {
+        if (!large_) return 0;
+        return sizeof(Large) + large_->entries.capacity() * sizeof(value_type) + ApproxTableBytes(large_->index);
+    }
+
+private:
+    struct Large {
+        std::vector<value_type> entries;
+        absl::flat_hash_map<Key, uint32_t, Hash, KeyEqual> index;  ///< key -> position in entries.
+    };
+
+    value_type* inline_entry(size_t i) { return std::launder(reinterpret_cast<value_type*>(storage_)) + i; }
+    const value_type* inline_entry(size_t i) const {
+        return std::launder(reinterpret_cast<const value_type*>(storage_)) + i;
+    }
+
+    /// Moves the inline entries to the heap; called on the (N+1)-th insert.
+    void spill() {
+        auto large = std::make_unique<Large>();
+        large->entries.reserve(2 * N);
+        large->index.reserve(2 * N);
+        for (size_t i = 0; i < size_; ++i) {
+            large->index.emplace(inline_entry(i)->first, static_cast<uint32_t>(i));
+            large->entries.push_back(std::move(*inline_entry(i)));
+        }
+        destroy_inline();
+        large_ = std::move(large);
+    }
+
+    /// Takes the contents of @p other, leaving it empty; this map must be empty.
+    void take(SmallMap& other) noexcept {
+        if (other.large_) {
+            large_ = std::move(other.large_);
+            return;
+        }
+        for (size_t i = 0; i < other.size_; ++i) {
+            ::new (inline_entry(i)) value_type(std::move(*other.inline_entry(i)));
+        }
+        size_ = other.size_;
+        other.destroy_inline();
+    }
+
+    void destroy_inline() {
+        for (size_t i = 0; i < size_; ++i) inline_entry(i)->~value_type();
+        size_ = 0;
+    }
+
+    void clear() {
+        destroy_inline();
+        large_.reset();
+    }
+
+    uint32_t size_ = 0;  ///< Inline entries in use; unused once large.
+    std::unique_ptr<Large> large_;
+    alignas(value_type) unsigned char storage_[N * sizeof(value_type)];
+};
@@ -0,0 +1,203 @@
+/**
+ * @file small_maps_benchmarks.cpp
+ * @brief Many tiny maps: per-map overhead, empty-map cost, lookups across maps.
+ *
+ * Models one small map per entity: `maps` maps (tens to hundreds of
+ * thousands) whose sizes follow a distribution (argument `sizes`):
+ * - 0: all empty.
+ * - 1: uniform in [0, 32].
+ * - 2: skewed, geometric with mean 3 (capped at 32): most maps hold a few
+ *      entries, a handful hold many.
+ *
+ * Benchmarks cover:
+ * - BM_SmallMapsBuild: constructing and filling all maps (`maps` per second).
+ *   Reports `bytes_per_map` (object plus heap, over all maps), `sizeof_map`
+ *   and `heap_per_entry`.
+ * - BM_SmallMapsLookup: lookups of random (map, key) pairs, hitting where
+ *   the chosen map is non-empty.
+ * - BM_SmallMapsDestroy: destroying all maps.
+ *
+ * Contenders include SmallMap (small_map.h), which holds its first 8 or 16
+ * entries inline and never allocates below that.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+#include "small_map.h"
+#include "memory_usage.h"
+
+// Largest map in every size distribution.
+static constexpr uint32_t kMaxMapSize = 32;
+// Lookups per pass of BM_SmallMapsLookup.
+static constexpr size_t kQueries = size_t{1} << 20;
+
+/**
+ * @brief Keys of every map, flattened: map i owns keys[offsets[i], offsets[i + 1]).
+ */
+struct SmallMapsInput {
+    std::vector<uint32_t> offsets{0};
+    std::vector<int> keys;
+
+    size_t maps() const { return offsets.size() - 1; }
+};
+
+/**
+ * @brief @p maps key lists with sizes from distribution @p sizes (see file comment).
+ */
+static SmallMapsInput MakeInput(size_t maps, int sizes) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> uniform_size(0, kMaxMapSize);
+    std::geometric_distribution<uint32_t> skewed_size(0.25);
+    std::uniform_int_distribution<int> key_dis(0, (1 << 30) - 1);
+
+    SmallMapsInput input;
+    for (size_t i = 0; i < maps; ++i) {
+        uint32_t size = 0;
+        if (sizes == 1) size = uniform_size(gen);
+        if (sizes == 2) size = std::min(skewed_size(gen), kMaxMapSize);
+
+        const size_t begin = input.offsets.back();
+        while (input.keys.size() - begin < size) {
+            const int key = key_dis(gen);
+            if (std::find(input.keys.begin() + begin, input.keys.end(), key) == input.keys.end()) {
+                input.keys.push_back(key);
+            }
+        }
+        input.offsets.push_back(static_cast<uint32_t>(input.keys.size()));
+    }
+    return input;
+}
+
+template<typename Hashmap>
+static void Fill(std::vector<Hashmap>& maps, const SmallMapsInput& input) {
+    for (size_t m = 0; m < maps.size(); ++m) {
+        for (uint32_t i = input.offsets[m]; i < input.offsets[m + 1]; ++i) {
+            maps[m][input.keys[i]] = static_cast<int>(i);
+        }
+    }
+}
+
+/**
+ * @brief Constructs and fills every map; destruction is not timed.
+ * Arguments: range(0) = number of maps, range(1) = size distribution.
+ */
+template<typename Hashmap>
+static void BM_SmallMapsBuild(benchmark::State& state) {
+    const SmallMapsInput input = MakeInput(state.range(0), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        {
+            std::vector<Hashmap> maps(input.maps());
+            Fill(maps, input);
+            benchmark::DoNotOptimize(maps.data());
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * input.maps());
+
+    const size_t heap_before = HeapBytesInUse();
+    std::vector<Hashmap> maps(input.maps());
+    Fill(maps, input);
+    size_t bytes = HeapBytesInUse();
+    if (bytes > heap_before) {
+        bytes -= heap_before;
+    } else {
+        bytes = maps.size() * sizeof(Hashmap);
+        for (const Hashmap& map : maps) bytes += ApproxTableBytes(map);
+    }
+    const size_t objects = maps.size() * sizeof(Hashmap);
+    state.counters["sizeof_map"] = sizeof(Hashmap);
+    state.counters["bytes_per_map"] = static_cast<double>(bytes) / maps.size();
+    state.counters["heap_per_entry"] = input.keys.empty() ? 0.0
+        : static_cast<double>(bytes > objects ? bytes - objects : 0) / input.keys.size();
+}
+
+/**
+ * @brief Lookups of random (map, key) pairs: a key of the map if it has any, else a miss.
+ * Arguments: range(0) = number of maps, range(1) = size distribution.
+ */
+template<typename Hashmap>
+static void BM_SmallMapsLookup(benchmark::State& state) {
+    const SmallMapsInput input = MakeInput(state.range(0), static_cast<int>(state.range(1)));
+    std::vector<Hashmap> maps(input.maps());
+    Fill(maps, input);
+
+    struct Query {
+        uint32_t map;
+        int key;
+    };
+    std::vector<Query> queries(kQueries);
+    std::mt19937 gen(123);
+    std::uniform_int_distribution<uint32_t> map_dis(0, static_cast<uint32_t>(input.maps() - 1));
+    for (Query& query : queries) {
+        query.map = map_dis(gen);
+        const uint32_t begin = input.offsets[query.map];
+        const uint32_t size = input.offsets[query.map + 1] - begin;
+        query.key = size ? input.keys[begin + gen() % size] : static_cast<int>(gen() >> 1);
+    }
+
+    size_t idx = 0;
+    int64_t sum = 0;
+    for (auto _ : state) {
+        const Query& query = queries[idx];
+        const Hashmap& map = maps[query.map];
+        auto it = map.find(query.key);
+        sum += it != map.end() ? it->second : 1;
+        if (++idx == queries.size()) idx = 0;
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Destroys every map; construction is not timed.
+ * Arguments: range(0) = number of maps, range(1) = size distribution.
+ */
+template<typename Hashmap>
+static void BM_SmallMapsDestroy(benchmark::State& state) {
+    const SmallMapsInput input = MakeInput(state.range(0), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto maps = std::make_unique<std::vector<Hashmap>>(input.maps());
+        Fill(*maps, input);
+        state.ResumeTiming();
+        maps.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * input.maps());
+}
+
+static void SmallMapsArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"maps", "sizes"});
+    for (int64_t maps : {int64_t{1} << 14, int64_t{1} << 18}) {
+        for (int64_t sizes : {0, 1, 2}) {
+            bench->Args({maps, sizes});
+        }
+    }
+}
+
+#define REGISTER_SMALL_MAPS(...)                                                \
+    BENCHMARK_TEMPLATE(BM_SmallMapsBuild, __VA_ARGS__)->Apply(SmallMapsArgs);   \
+    BENCHMARK_TEMPLATE(BM_SmallMapsLookup, __VA_ARGS__)->Apply(SmallMapsArgs);  \
+    BENCHMARK_TEMPLATE(BM_SmallMapsDestroy, __VA_ARGS__)->Apply(SmallMapsArgs)
+
+// Register benchmarks
+REGISTER_SMALL_MAPS(std::unordered_map<int, int>);
+REGISTER_SMALL_MAPS(absl::flat_hash_map<int, int>);
+REGISTER_SMALL_MAPS(robin_hood::unordered_map<int, int>);
+REGISTER_SMALL_MAPS(phmap::flat_hash_map<int, int>);
+REGISTER_SMALL_MAPS(SparseHashMap<int, int>);
+REGISTER_SMALL_MAPS(SmallMap<int, int, 8>);
+REGISTER_SMALL_MAPS(SmallMap<int, int, 16>);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,240 @@
+/**
+ * @file soak_benchmarks.cpp
+ * @brief Long-running mixed workload per map, sampled over time: throughput, RSS, fragmentation, capacity.
+ *
+ * Microbenchmarks run for milliseconds; services keep a map alive for weeks.
+ * Every run here drives one map with a mixed workload for --soak_seconds
+ * (default 10) and samples it every --soak_interval_ms (default 250). The
+ * live keys are a sliding range of a scrambled key sequence: inserts add
+ * keys at the head, erases remove them at the tail, lookups hit random
+ * live keys (4 lookups per insert and per erase). Argument `pattern`:
+ * - 0 (steady): every insert is paired with an erase, N keys stay live.
+ * - 1 (spike): the live set repeatedly grows from N to 8N keys (inserts
+ *   only) and shrinks back to N (erases only), which shows whether a map
+ *   ever gives memory back after a load spike.
+ *
+ * Each sample records ops/sec since the previous sample, size, capacity
+ * (buckets), RSS and the allocator's in-use / free / mmap'd bytes
+ * (mallinfo2). --soak_out=FILE writes all samples of all runs as a JSON
+ * time series. The benchmark result summarizes each run:
+ * - `throughput_drift`: ops/sec of the last sample over the first, minus 1.
+ * - `rss_growth`: RSS at the end minus RSS after the first sample.
+ * - `heap_free_end`: free bytes held by the allocator at the end (fragmentation).
+ * - `capacity_end`: buckets at the end; for `pattern` 1 compare with the N-key size.
+ *
+ * The heap is trimmed before every run, but RSS is process-wide: run one
+ * contender per process (--benchmark_filter) for the cleanest RSS curves.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "memory_usage.h"
+
+/**
+ * @brief One point of a run's time series.
+ */
+struct SoakSample {
+    double seconds;  ///< Since the start of the run.
+    double ops_per_second;
+    size_t size;
+    size_t capacity;
+    size_t rss_bytes;
+    HeapStats heap;
+};
+
+struct SoakRun {
+    std::string contender;
+    int64_t n;
+    int64_t pattern;
+    std::vector<SoakSample> samples;
+};
+
+// Run length and sampling interval (--soak_seconds, --soak_interval_ms), and
+// where to write the time series (--soak_out).
+static double g_soak_seconds = 10;
+static double g_soak_interval_ms = 250;
+static std::string g_soak_out;
+static std::vector<SoakRun> g_soak_runs;
+
+/**
+ * @brief i-th key of the key sequence: distinct for every i < 2^32, in scrambled order.
+ */
+static int SoakKey(uint32_t i) {
+    return static_cast<int>(i * 2654435761u);
+}
+
+/**
+ * @brief Buckets of @p map, or its size for maps that do not expose them.
+ */
+template<typename Hashmap>
+static size_t TableCapacity(const Hashmap& map) {
+    if constexpr (requires { map.bucket_count(); }) {
+        return map.bucket_count();
+    } else if constexpr (requires { map.mask(); }) {
+        return map.mask() + 1;
+    } else {
+        return map.size();
+    }
+}
+
+/**
+ * @brief Mixed workload for --soak_seconds, one iteration.
+ * Arguments: range(0) = N live keys, range(1) = pattern (0 steady, 1 spike).
+ */
+template<typename Hashmap>
+static void BM_Soak(benchmark::State& state, const char* contender) {
+    using Clock = std::chrono::steady_clock;
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    const bool spike = state.range(1) == 1;
+    const uint32_t spike_size = 8 * n;
+    const auto interval = std::chrono::duration<double, std::milli>(g_soak_interval_ms);
+    const auto duration = std::chrono::duration<double>(g_soak_seconds);
+
+    ReleaseFreeHeap();
+    SoakRun run{contender, state.range(0), state.range(1), {}};
+    uint64_t ops = 0;
+    int64_t sum = 0;
+
+    for (auto _ : state) {
+        Hashmap map;
+        // Live keys are SoakKey(tail) .. SoakKey(head - 1); the counters may wrap, the live range stays distinct.
+        uint32_t head = 0, tail = 0;
+        for (; head < n; ++head) map[SoakKey(head)] = static_cast<int>(head);
+        bool growing = true;
+        uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+        const Clock::time_point start = Clock::now();
+        Clock::time_point last_sample = start;
+        uint64_t ops_at_last_sample = 0;
+        for (;;) {
+            // 4096 rounds of 4 lookups, one insert and one erase (or two of one kind while spiking).
+            for (int round = 0; round < 4096; ++round) {
+                for (int l = 0; l < 4; ++l) {
+                    rng ^= rng << 13;
+                    rng ^= rng >> 7;
+                    rng ^= rng << 17;
+                    const uint32_t live = head - tail;
+                    sum += map.find(SoakKey(tail + static_cast<uint32_t>((rng >> 32) % live)))->second;
+                }
+                for (int update = 0; update < 2; ++update) {
+                    const bool insert = spike ? growing : update == 0;
+                    if (insert) {
+                        map[SoakKey(head)] = static_cast<int>(head);
+                        ++head;
+                    } else {
+                        map.erase(SoakKey(tail));
+                        ++tail;
+                    }
+                    if (spike && growing && head - tail >= spike_size) growing = false;
+                    if (spike && !growing && head - tail <= n) growing = true;
+                }
+            }
+            ops += 4096 * 6;
+
+            const Clock::time_point now = Clock::now();
+            if (now - last_sample >= interval) {
+                const double elapsed = std::chrono::duration<double>(now - last_sample).count();
+                run.samples.push_back({std::chrono::duration<double>(now - start).count(),
+                                       (ops - ops_at_last_sample) / elapsed, map.size(), TableCapacity(map),
+                                       ResidentBytes(), ReadHeapStats()});
+                last_sample = now;
+                ops_at_last_sample = ops;
+            }
+            if (now - start >= duration) break;
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+
+    state.SetItemsProcessed(ops);
+    if (!run.samples.empty()) {
+        const SoakSample& first = run.samples.front();
+        const SoakSample& last = run.samples.back();
+        state.counters["throughput_drift"] = first.ops_per_second > 0 ? last.ops_per_second / first.ops_per_second - 1 : 0.0;
+        state.counters["rss_growth"] = static_cast<double>(last.rss_bytes) - static_cast<double>(first.rss_bytes);
+        state.counters["heap_free_end"] = static_cast<double>(last.heap.free);
+        state.counters["capacity_end"] = static_cast<double>(last.capacity);
+    }
+    g_soak_runs.push_back(std::move(run));
+}
+
+/**
+ * @brief 64K and 1M live keys, steady and spiking, each run once for --soak_seconds.
+ */
+static void SoakArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"N", "pattern"});
+    for (int64_t n : {int64_t{1} << 16, int64_t{1} << 20}) {
+        for (int64_t pattern : {0, 1}) bench->Args({n, pattern});
+    }
+    bench->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+// The contender's name goes into the time series next to its samples.
+#define REGISTER_SOAK(...) \
+    benchmark::RegisterBenchmark("BM_Soak<" #__VA_ARGS__ ">", BM_Soak<__VA_ARGS__>, #__VA_ARGS__)->Apply(SoakArgs)
+
+static void WriteSoakRuns(const std::string& path) {
+    std::ofstream out(path);
+    out << "{\"soak_seconds\": " << g_soak_seconds << ", \"interval_ms\": " << g_soak_interval_ms
+        << ", \"runs\": [\n";
+    for (size_t r = 0; r < g_soak_runs.size(); ++r) {
+        const SoakRun& run = g_soak_runs[r];
+        out << (r ? ",\n" : "") << "  {\"contender\": \"" << run.contender << "\", \"N\": " << run.n
+            << ", \"pattern\": " << run.pattern << ", \"samples\": [";
+        for (size_t i = 0; i < run.samples.size(); ++i) {
+            const SoakSample& s = run.samples[i];
+            out << (i ? ",\n" : "\n") << "    {\"t\": " << s.seconds << ", \"ops_per_second\": " << s.ops_per_second
+                << ", \"size\": " << s.size << ", \"capacity\": " << s.capacity << ", \"rss_bytes\": " << s.rss_bytes
+                << ", \"heap_in_use\": " << s.heap.in_use << ", \"heap_free\": " << s.heap.free
+                << ", \"heap_mmap\": " << s.heap.mapped << '}';
+        }
+        out << "\n  ]}";
+    }
+    out << "\n]}\n";
+}
+
+// Removes our own flags from argv before Google Benchmark parses the rest.
+static void ParseFlags(int* argc, char** argv) {
+    const char* kSecondsFlag = "--soak_seconds=";
+    const char* kIntervalFlag = "--soak_interval_ms=";
+    const char* kOutFlag = "--soak_out=";
+    int out = 1;
+    for (int i = 1; i < *argc; ++i) {
+        if (std::strncmp(argv[i], kSecondsFlag, std::strlen(kSecondsFlag)) == 0) {
+            g_soak_seconds = std::strtod(argv[i] + std::strlen(kSecondsFlag), nullptr);
+        } else if (std::strncmp(argv[i], kIntervalFlag, std::strlen(kIntervalFlag)) == 0) {
+            g_soak_interval_ms = std::strtod(argv[i] + std::strlen(kIntervalFlag), nullptr);
+        } else if (std::strncmp(argv[i], kOutFlag, std::strlen(kOutFlag)) == 0) {
+            g_soak_out = argv[i] + std::strlen(kOutFlag);
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    *argc = out;
+}
+
+int main(int argc, char** argv) {
+    ParseFlags(&argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    REGISTER_SOAK(std::unordered_map<int, int>);
+    REGISTER_SOAK(absl::flat_hash_map<int, int>);
+    REGISTER_SOAK(robin_hood::unordered_map<int, int>);
+    REGISTER_SOAK(phmap::flat_hash_map<int, int>);
+
+    benchmark::RunSpecifiedBenchmarks();
+    if (!g_soak_out.empty()) WriteSoakRuns(g_soak_out);
+    benchmark::Shutdown();
+    return 0;
+}
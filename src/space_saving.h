@@ -0,0 +1,126 @@
+/**
+ * @file space_saving.h
+ * @brief Space-Saving top-K heavy hitter summary (Metwally et al.).
+ *
+ * Monitors at most `capacity` keys. A monitored key's counter is
+ * incremented; an unmonitored key replaces the key with the smallest
+ * counter and inherits that counter plus one, remembering it as the
+ * maximum overestimation (`error`). Every key whose true count exceeds
+ * N / capacity is guaranteed to be monitored.
+ *
+ * The counters form a binary min-heap, and a flat hash map locates the
+ * heap slot of each monitored key, so every update is O(log capacity).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+
+template<typename Key, typename Hash = absl::Hash<Key>>
+class SpaceSaving {
+public:
+    /**
+     * @brief One monitored key.
+     */
+    struct Counter {
+        Key key;
+        uint64_t count;  ///< Upper bound of the true count.
+        uint64_t error;  ///< count - error is a lower bound of the true count.
+    };
+
+    explicit SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+    /**
+     * @brief Adds one occurrence of @p key.
+     */
+    void add(const Key& key) {
+        auto it = slots_.find(key);
+        if (it != slots_.end()) {
+            heap_[it->second].count++;
+            sift_down(it->second);
+            return;
+        }
+        if (heap_.size() < capacity_) {
+            if (heap_.empty()) {
+                // Allocate on first use, so an empty summary costs nothing.
+                heap_.reserve(capacity_);
+                slots_.reserve(capacity_);
+            }
+            heap_.push_back({key, 1, 0});
+            slots_[key] = heap_.size() - 1;
+            sift_up(heap_.size() - 1);
+            return;
+        }
+        // Replace the minimum: the newcomer may have occurred up to min times unseen.
+        Counter& min = heap_[0];
+        slots_.erase(min.key);
+        min = {key, min.count + 1, min.count};
+        slots_[key] = 0;
+        sift_down(0);
+    }
+
+    /**
+     * @brief Monitored keys, highest count first, at most @p k of them.
+     */
+    std::vector<Counter> top(size_t k) const {
+        std::vector<Counter> result = heap_;
+        const size_t n = std::min(k, result.size());
+        std::partial_sort(result.begin(), result.begin() + n, result.end(),
+                          [](const Counter& a, const Counter& b) { return a.count > b.count; });
+        result.resize(n);
+        return result;
+    }
+
+    /**
+     * @brief Estimated count of @p key: its counter if monitored, else 0.
+     */
+    uint64_t estimate(const Key& key) const {
+        auto it = slots_.find(key);
+        return it == slots_.end() ? 0 : heap_[it->second].count;
+    }
+
+    size_t size() const { return heap_.size(); }
+    size_t capacity() const { return capacity_; }
+    /// Approximate heap bytes: the heap array plus the index's slots and control bytes.
+    size_t allocated_bytes() const {
+        return heap_.capacity() * sizeof(Counter) + slots_.bucket_count() * (sizeof(std::pair<Key, size_t>) + 1);
+    }
+
+private:
+    void swap_slots(size_t a, size_t b) {
+        std::swap(heap_[a], heap_[b]);
+        slots_[heap_[a].key] = a;
+        slots_[heap_[b].key] = b;
+    }
+
+    void sift_up(size_t i) {
+        while (i > 0) {
+            const size_t parent = (i - 1) / 2;
+            if (heap_[parent].count <= heap_[i].count) break;
+            swap_slots(i, parent);
+            i = parent;
+        }
+    }
+
+    void sift_down(size_t i) {
+        for (;;) {
+            const size_t left = 2 * i + 1;
+            if (left >= heap_.size()) return;
+            const size_t right = left + 1;
+            const size_t child = right < heap_.size() && heap_[right].count < heap_[left].count ? right : left;
+            if (heap_[i].count <= heap_[child].count) return;
+            swap_slots(i, child);
+            i = child;
+        }
+    }
+
+    size_t capacity_;
+    std::vector<Counter> heap_;                      ///< Min-heap on count.
+    absl::flat_hash_map<Key, size_t, Hash> slots_;   ///< key -> index in heap_.
+};
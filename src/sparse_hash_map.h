@@ -0,0 +1,326 @@
+/**
+ * @file sparse_hash_map.h
+ * @brief Memory-lean open addressing map in the style of sparsehash/sparsepp.
+ *
+ * The slot array is split into groups of 64 slots. A group stores a 64-bit
+ * bitmap of occupied slots and a pointer to a packed array holding only the
+ * occupied entries:
+ *
+ *     group: | bitmap (8 bytes) | entries* (8 bytes) |  -> [e0, e1, ...]
+ *
+ * An empty slot therefore costs 2 bits instead of a full `value_type`, and
+ * entry `i` of a group is found at `popcount(bitmap & ((1 << i) - 1))`.
+ * Inserting shifts the tail of the packed array, so inserts are slower than
+ * in a flat map; in exchange the table can run at a low load factor (fewer
+ * probes) and still use less memory than a flat map at 7/8 load.
+ *
+ * Collisions are resolved by linear probing, so a run of neighbouring slots
+ * usually stays within one packed array. There is no erase: the benchmarks
+ * only insert, update and look up.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "absl/hash/hash.h"
+
+template<typename Key, typename Value, typename Hash = absl::Hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class SparseHashMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+
+    /// Range max_load_factor() is clamped to.
+    static constexpr float kMinLoadFactor = 0.1f;
+    static constexpr float kMaxLoadFactor = 0.95f;
+
+private:
+    static constexpr size_t kGroupSlots = 64;
+    // Packed arrays grow in steps of this many entries, so an insert only
+    // reallocates every few entries instead of every time.
+    static constexpr size_t kGrowStep = 4;
+
+    struct Group {
+        uint64_t bitmap = 0;
+        value_type* entries = nullptr;
+
+        size_t count() const { return static_cast<size_t>(std::popcount(bitmap)); }
+        // Index of slot @p bit in the packed array.
+        size_t rank(size_t bit) const { return static_cast<size_t>(std::popcount(bitmap & ((uint64_t{1} << bit) - 1))); }
+        bool occupied(size_t bit) const { return (bitmap >> bit) & 1; }
+    };
+
+    static size_t AllocatedEntries(size_t count) { return (count + kGrowStep - 1) / kGrowStep * kGrowStep; }
+
+    template<bool Const>
+    class Iterator {
+        using Map = std::conditional_t<Const, const SparseHashMap, SparseHashMap>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = SparseHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        Iterator() = default;
+        Iterator(Map* map, size_t group, size_t index) : map_(map), group_(group), index_(index) {}
+        // Allows iterator -> const_iterator conversion.
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) : map_(other.map_), group_(other.group_), index_(other.index_) {}
+
+        reference operator*() const { return map_->groups_[group_].entries[index_]; }
+        pointer operator->() const { return &**this; }
+        Iterator& operator++() { ++index_; settle(); return *this; }
+        Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+        bool operator==(const Iterator& other) const { return group_ == other.group_ && index_ == other.index_; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class SparseHashMap;
+        template<bool> friend class Iterator;
+
+        // Skips exhausted groups.
+        void settle() {
+            while (group_ < map_->num_groups_ && index_ >= map_->groups_[group_].count()) {
+                ++group_;
+                index_ = 0;
+            }
+        }
+
+        Map* map_ = nullptr;
+        size_t group_ = 0;
+        size_t index_ = 0;
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SparseHashMap() = default;
+    SparseHashMap(const SparseHashMap&) = delete;
+    SparseHashMap& operator=(const SparseHashMap&) = delete;
+    SparseHashMap(SparseHashMap&& other) noexcept { swap(other); }
+    SparseHashMap& operator=(SparseHashMap&& other) noexcept {
+        if (this != &other) {
+            SparseHashMap moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+    ~SparseHashMap() { release(); }
+
+    Value& operator[](const Key& key) {
+        if (num_groups_ != 0) {
+            if (value_type* entry = lookup(key)) return entry->second;
+        }
+        if (static_cast<double>(size_ + 1) > static_cast<double>(max_load_) * bucket_count()) {
+            rehash(grown_capacity(size_ + 1));
+        }
+        return insert_new(key)->second;
+    }
+
+    iterator find(const Key& key) {
+        size_t group = 0, index = 0;
+        return locate(key, group, index) ? iterator(this, group, index) : end();
+    }
+
+    const_iterator find(const Key& key) const {
+        size_t group = 0, index = 0;
+        return locate(key, group, index) ? const_iterator(this, group, index) : end();
+    }
+
+    size_t count(const Key& key) const { return find(key) != end(); }
+
+    /**
+     * @brief Makes room for @p n entries without rehashing.
+     */
+    void reserve(size_t n) {
+        const size_t capacity = grown_capacity(n);
+        if (capacity > bucket_count()) rehash(capacity);
+    }
+
+    /**
+     * @brief Sets the load factor at which the table doubles (default 0.5).
+     *
+     * Clamped to [kMinLoadFactor, kMaxLoadFactor]: probing relies on the
+     * table always keeping an empty slot, and growth on a positive load.
+     */
+    void max_load_factor(float load) {
+        max_load_ = load >= kMinLoadFactor ? std::min(load, kMaxLoadFactor) : kMinLoadFactor;
+    }
+    float max_load_factor() const { return max_load_; }
+
+    iterator begin() { iterator it(this, 0, 0); it.settle(); return it; }
+    iterator end() { return iterator(this, num_groups_, 0); }
+    const_iterator begin() const { const_iterator it(this, 0, 0); it.settle(); return it; }
+    const_iterator end() const { return const_iterator(this, num_groups_, 0); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    /// Number of slots, occupied or not.
+    size_t bucket_count() const { return num_groups_ * kGroupSlots; }
+    /// Heap bytes of the group array plus every packed entry array.
+    size_t allocated_bytes() const { return num_groups_ * sizeof(Group) + allocated_entries_ * sizeof(value_type); }
+
+    /**
+     * @brief Number of extra slots probed to find @p key (for introspection).
+     */
+    size_t num_probes(const Key& key) const {
+        size_t probes = 0;
+        for (size_t slot = hash_(key) & mask_;; slot = (slot + 1) & mask_, ++probes) {
+            const Group& group = groups_[slot / kGroupSlots];
+            const size_t bit = slot % kGroupSlots;
+            if (!group.occupied(bit) || equal_(group.entries[group.rank(bit)].first, key)) return probes;
+        }
+    }
+
+    /**
+     * @brief Histogram of occupied slots per group: [k] = groups holding k entries.
+     */
+    std::vector<size_t> group_occupancy() const {
+        std::vector<size_t> histogram(kGroupSlots + 1, 0);
+        for (size_t g = 0; g < num_groups_; ++g) histogram[groups_[g].count()]++;
+        return histogram;
+    }
+
+    void swap(SparseHashMap& other) noexcept {
+        std::swap(groups_, other.groups_);
+        std::swap(num_groups_, other.num_groups_);
+        std::swap(mask_, other.mask_);
+        std::swap(size_, other.size_);
+        std::swap(allocated_entries_, other.allocated_entries_);
+        std::swap(max_load_, other.max_load_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+private:
+    // Smallest power-of-two slot count holding @p n entries at max_load_.
+    size_t grown_capacity(size_t n) const {
+        size_t capacity = kGroupSlots;
+        while (static_cast<double>(max_load_) * capacity < static_cast<double>(n)) capacity *= 2;
+        return capacity;
+    }
+
+    bool locate(const Key& key, size_t& group_index, size_t& index) const {
+        if (num_groups_ == 0) return false;
+        for (size_t slot = hash_(key) & mask_;; slot = (slot + 1) & mask_) {
+            const Group& group = groups_[slot / kGroupSlots];
+            const size_t bit = slot % kGroupSlots;
+            if (!group.occupied(bit)) return false;
+            const size_t rank = group.rank(bit);
+            if (equal_(group.entries[rank].first, key)) {
+                group_index = slot / kGroupSlots;
+                index = rank;
+                return true;
+            }
+        }
+    }
+
+    value_type* lookup(const Key& key) {
+        size_t group = 0, index = 0;
+        return locate(key, group, index) ? &groups_[group].entries[index] : nullptr;
+    }
+
+    // Inserts a key known to be absent, with a value-initialized mapped value.
+    value_type* insert_new(const Key& key) {
+        size_t slot = hash_(key) & mask_;
+        while (groups_[slot / kGroupSlots].occupied(slot % kGroupSlots)) slot = (slot + 1) & mask_;
+        ++size_;
+        return emplace_at(groups_[slot / kGroupSlots], slot % kGroupSlots, key, Value());
+    }
+
+    // Places a moved entry during rehash (keys are unique, no comparison needed).
+    void place(value_type&& entry) {
+        size_t slot = hash_(entry.first) & mask_;
+        while (groups_[slot / kGroupSlots].occupied(slot % kGroupSlots)) slot = (slot + 1) & mask_;
+        emplace_at(groups_[slot / kGroupSlots], slot % kGroupSlots, std::move(entry.first), std::move(entry.second));
+    }
+
+    template<typename K, typename V>
+    value_type* emplace_at(Group& group, size_t bit, K&& key, V&& value) {
+        const size_t count = group.count();
+        const size_t rank = group.rank(bit);
+        if (count == AllocatedEntries(count)) {
+            // Packed array is full: move into a larger one, leaving a hole at rank.
+            const size_t new_alloc = AllocatedEntries(count + 1);
+            value_type* fresh = allocate(new_alloc);
+            for (size_t i = 0; i < count; ++i) {
+                ::new (fresh + i + (i >= rank)) value_type(std::move(group.entries[i]));
+                group.entries[i].~value_type();
+            }
+            deallocate(group.entries, AllocatedEntries(count));
+            allocated_entries_ += new_alloc - AllocatedEntries(count);
+            group.entries = fresh;
+        } else if (rank < count) {
+            // Shift the tail one entry to the right to open the hole at rank.
+            ::new (group.entries + count) value_type(std::move(group.entries[count - 1]));
+            for (size_t i = count - 1; i > rank; --i) group.entries[i] = std::move(group.entries[i - 1]);
+            group.entries[rank].~value_type();
+        }
+        ::new (group.entries + rank) value_type(std::forward<K>(key), std::forward<V>(value));
+        group.bitmap |= uint64_t{1} << bit;
+        return group.entries + rank;
+    }
+
+    void rehash(size_t new_capacity) {
+        std::unique_ptr<Group[]> old = std::move(groups_);
+        const size_t old_groups = num_groups_;
+
+        num_groups_ = new_capacity / kGroupSlots;
+        groups_ = std::make_unique<Group[]>(num_groups_);
+        mask_ = new_capacity - 1;
+        allocated_entries_ = 0;
+
+        for (size_t g = 0; g < old_groups; ++g) {
+            const size_t count = old[g].count();
+            for (size_t i = 0; i < count; ++i) {
+                place(std::move(old[g].entries[i]));
+                old[g].entries[i].~value_type();
+            }
+            deallocate(old[g].entries, AllocatedEntries(count));
+        }
+    }
+
+    void release() {
+        for (size_t g = 0; g < num_groups_; ++g) {
+            const size_t count = groups_[g].count();
+            for (size_t i = 0; i < count; ++i) groups_[g].entries[i].~value_type();
+            deallocate(groups_[g].entries, AllocatedEntries(count));
+        }
+        groups_.reset();
+        num_groups_ = 0;
+        size_ = 0;
+        allocated_entries_ = 0;
+    }
+
+    static value_type* allocate(size_t n) {
+        return static_cast<value_type*>(::operator new(n * sizeof(value_type), std::align_val_t{alignof(value_type)}));
+    }
+
+    static void deallocate(value_type* entries, size_t n) {
+        if (entries) ::operator delete(entries, n * sizeof(value_type), std::align_val_t{alignof(value_type)});
+    }
+
+    std::unique_ptr<Group[]> groups_;
+    size_t num_groups_ = 0;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    size_t allocated_entries_ = 0;  ///< Entries allocated across all packed arrays.
+    float max_load_ = 0.5f;
+    Hash hash_;
+    KeyEqual equal_;
+};
@@ -0,0 +1,324 @@
+/**
+ * @file static_hash_table.h
+ * @brief Read-only hash table bulk-built from key and value arrays on a worker pool.
+ *
+ * Building a map with N serial inserts is one thread of random writes.
+ * StaticHashTable is built in one call from all its entries instead, and
+ * the table is split into partitions by hash prefix: the top bits of a
+ * key's hash pick its partition, a contiguous range of slots, and the low
+ * bits its home slot inside it. Since no probe chain leaves its partition,
+ * workers fill different partitions without any locking:
+ *
+ * 1. Every worker hashes a block of the input and counts its keys per
+ *    256-way hash prefix.
+ * 2. Prefix sums of the counts give each (prefix, worker) pair its own
+ *    output range; every worker scatters the indices of its block there.
+ *    The scatter is stable, so each prefix lists its keys in input order.
+ * 3. Workers claim partitions one at a time and insert their keys with
+ *    linear probing (wrapping around inside the partition).
+ *
+ * Duplicate keys keep the value that comes last in the input, as serial
+ * `map[key] = value` would. The table is sized for the number of input rows
+ * and doubles its capacity before step 3 if some partition would be loaded
+ * beyond kMaxPartitionLoad. If the row counts overload a partition, the input
+ * may repeat keys, so build() first counts the distinct keys of every prefix
+ * (sorting its keys by hash) and sizes the table by those instead.
+ *
+ *     WorkerPool pool(8);
+ *     StaticHashTable<int, int> table;
+ *     table.build(keys, values, pool);
+ *     const auto* entry = table.find(42);  // nullptr if absent
+ *
+ * find() returns a pointer to the entry and end() is nullptr. The table
+ * cannot be modified after build() other than by building it again.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "absl/hash/hash.h"
+#include "batch_scheduler.h"
+
+template<typename Key, typename Value, typename Hash = absl::Hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class StaticHashTable {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using const_iterator = const value_type*;
+
+    /// Average load the capacity is sized for.
+    static constexpr double kMaxLoad = 0.75;
+    /// Highest load of any single partition; a table that would exceed it is doubled.
+    static constexpr double kMaxPartitionLoad = 0.9;
+
+    StaticHashTable() = default;
+    StaticHashTable(const StaticHashTable&) = delete;
+    StaticHashTable& operator=(const StaticHashTable&) = delete;
+    StaticHashTable(StaticHashTable&& other) noexcept { swap(other); }
+    StaticHashTable& operator=(StaticHashTable&& other) noexcept {
+        if (this != &other) {
+            StaticHashTable moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+    ~StaticHashTable() { release(); }
+
+    /**
+     * @brief Replaces the contents with keys[i] -> values[i], built on the workers of @p pool.
+     */
+    void build(const std::vector<Key>& keys, const std::vector<Value>& values, WorkerPool& pool) {
+        if (keys.size() != values.size()) throw std::invalid_argument("StaticHashTable: keys and values differ in size");
+        if (keys.size() > UINT32_MAX) throw std::length_error("StaticHashTable: more than 2^32 entries");
+        release();
+        const size_t n = keys.size();
+        const size_t workers = pool.size();
+
+        // 1. Hash every key and count keys per prefix, per worker.
+        std::unique_ptr<size_t[]> hashes(new size_t[n]);
+        std::vector<size_t> counts(workers * kPrefixes);
+        pool.run([&](size_t w) {
+            size_t* count = &counts[w * kPrefixes];
+            for (size_t i = BlockBegin(n, workers, w), end = BlockBegin(n, workers, w + 1); i < end; ++i) {
+                hashes[i] = hash_(keys[i]);
+                ++count[Prefix(hashes[i])];
+            }
+        });
+
+        // Output range of every (prefix, worker): prefix-major, so each prefix's keys are contiguous.
+        std::vector<size_t> prefix_begin(kPrefixes + 1);
+        size_t offset = 0;
+        for (size_t p = 0; p < kPrefixes; ++p) {
+            prefix_begin[p] = offset;
+            for (size_t w = 0; w < workers; ++w) {
+                const size_t count = counts[w * kPrefixes + p];
+                counts[w * kPrefixes + p] = offset;
+                offset += count;
+            }
+        }
+        prefix_begin[kPrefixes] = offset;
+
+        // 2. Scatter input indices by prefix.
+        std::unique_ptr<uint32_t[]> order(new uint32_t[n]);
+        pool.run([&](size_t w) {
+            size_t* next = &counts[w * kPrefixes];
+            for (size_t i = BlockBegin(n, workers, w), end = BlockBegin(n, workers, w + 1); i < end; ++i) {
+                order[next[Prefix(hashes[i])]++] = static_cast<uint32_t>(i);
+            }
+        });
+
+        // Rows that overload a partition are usually repeated keys: size by distinct keys then.
+        if (!try_layout(MinCapacity(n), prefix_begin)) {
+            choose_layout(count_distinct(keys, hashes.get(), order.get(), prefix_begin, pool));
+        }
+
+        // 3. Fill the partitions; each is owned by the worker that claimed it.
+        allocate();
+        const size_t partitions = size_t{1} << partition_bits_;
+        const size_t prefixes_per_partition = kPrefixes >> partition_bits_;
+        std::atomic<size_t> next_partition{0};
+        std::atomic<size_t> inserted{0};
+        pool.run([&](size_t) {
+            size_t local = 0;
+            for (size_t p; (p = next_partition.fetch_add(1, std::memory_order_relaxed)) < partitions;) {
+                const size_t begin = prefix_begin[p * prefixes_per_partition];
+                const size_t end = prefix_begin[(p + 1) * prefixes_per_partition];
+                for (size_t k = begin; k < end; ++k) {
+                    const uint32_t i = order[k];
+                    local += place(hashes[i], keys[i], values[i]);
+                }
+            }
+            inserted.fetch_add(local, std::memory_order_relaxed);
+        });
+        size_ = inserted.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief The entry of @p key, or nullptr (end()) if absent.
+     */
+    const value_type* find(const Key& key) const {
+        if (!ctrl_) return nullptr;
+        const size_t hash = hash_(key);
+        const size_t base = partition_of(hash) << partition_shift_;
+        const size_t mask = (size_t{1} << partition_shift_) - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            if (!ctrl_[base + i]) return nullptr;
+            if (equal_(slots_[base + i].first, key)) return &slots_[base + i];
+        }
+    }
+
+    size_t count(const Key& key) const { return find(key) != nullptr; }
+    const_iterator end() const { return nullptr; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t bucket_count() const { return capacity_; }
+    /// Partitions the slots are split into.
+    size_t partitions() const { return size_t{1} << partition_bits_; }
+    /// Heap bytes of the table (the build's temporary arrays are freed by then).
+    size_t allocated_bytes() const { return capacity_ * (1 + sizeof(value_type)); }
+
+    void swap(StaticHashTable& other) noexcept {
+        std::swap(ctrl_, other.ctrl_);
+        std::swap(slots_, other.slots_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(partition_bits_, other.partition_bits_);
+        std::swap(partition_shift_, other.partition_shift_);
+        std::swap(size_, other.size_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+private:
+    static constexpr size_t kPrefixBits = 8;
+    static constexpr size_t kPrefixes = size_t{1} << kPrefixBits;
+    /// Smallest partition worth its own range; small tables use fewer partitions.
+    static constexpr size_t kMinPartitionSlots = 4096;
+    static constexpr size_t kMinCapacity = 16;
+    static constexpr size_t kHashBits = 8 * sizeof(size_t);
+    static_assert(alignof(value_type) <= alignof(std::max_align_t), "slots come from malloc");
+
+    static size_t Prefix(size_t hash) { return hash >> (kHashBits - kPrefixBits); }
+
+    size_t partition_of(size_t hash) const { return Prefix(hash) >> (kPrefixBits - partition_bits_); }
+
+    /// Smallest capacity holding @p n keys at kMaxLoad.
+    static size_t MinCapacity(size_t n) {
+        size_t capacity = kMinCapacity;
+        while (static_cast<double>(n) > kMaxLoad * capacity) capacity *= 2;
+        return capacity;
+    }
+
+    /// Sets capacity and partition count from the number of keys per prefix (as prefix sums).
+    void choose_layout(const std::vector<size_t>& key_begin) {
+        size_t capacity = MinCapacity(key_begin[kPrefixes]);
+        while (!try_layout(capacity, key_begin)) capacity *= 2;
+    }
+
+    /// Takes the layout for @p capacity slots unless a partition would be loaded beyond kMaxPartitionLoad.
+    bool try_layout(size_t capacity, const std::vector<size_t>& key_begin) {
+        size_t bits = 0;
+        while (bits < kPrefixBits && (capacity >> (bits + 1)) >= kMinPartitionSlots) ++bits;
+        const size_t prefixes_per_partition = kPrefixes >> bits;
+        size_t fullest = 0;
+        for (size_t p = 0; p < kPrefixes; p += prefixes_per_partition) {
+            fullest = std::max(fullest, key_begin[p + prefixes_per_partition] - key_begin[p]);
+        }
+        const size_t partition_slots = capacity >> bits;
+        if (static_cast<double>(fullest) > kMaxPartitionLoad * partition_slots) return false;
+        capacity_ = capacity;
+        partition_bits_ = bits;
+        partition_shift_ = 0;
+        while ((size_t{1} << partition_shift_) < partition_slots) ++partition_shift_;
+        return true;
+    }
+
+    /**
+     * @brief Prefix sums of the distinct keys per prefix.
+     *
+     * Sorts every prefix's indices by (hash, input index), so equal keys stay
+     * in input order and the last one still wins in step 3, then compares
+     * keys only within runs of equal hashes, against the distinct keys found
+     * so far in the run.
+     */
+    std::vector<size_t> count_distinct(const std::vector<Key>& keys, const size_t* hashes, uint32_t* order,
+                                       const std::vector<size_t>& prefix_begin, WorkerPool& pool) const {
+        std::vector<size_t> distinct(kPrefixes + 1);
+        std::atomic<size_t> next_prefix{0};
+        pool.run([&](size_t) {
+            std::vector<uint32_t> run;
+            for (size_t p; (p = next_prefix.fetch_add(1, std::memory_order_relaxed)) < kPrefixes;) {
+                uint32_t* begin = order + prefix_begin[p];
+                uint32_t* end = order + prefix_begin[p + 1];
+                std::sort(begin, end, [&](uint32_t a, uint32_t b) {
+                    return hashes[a] != hashes[b] ? hashes[a] < hashes[b] : a < b;
+                });
+                size_t count = 0;
+                for (const uint32_t* k = begin; k != end; ++k) {
+                    if (k == begin || hashes[*k] != hashes[k[-1]]) run.clear();
+                    const bool seen = std::any_of(run.begin(), run.end(),
+                                                  [&](uint32_t i) { return equal_(keys[i], keys[*k]); });
+                    if (!seen) {
+                        run.push_back(*k);
+                        ++count;
+                    }
+                }
+                distinct[p] = count;
+            }
+        });
+        size_t offset = 0;
+        for (size_t p = 0; p <= kPrefixes; ++p) {
+            const size_t count = distinct[p];
+            distinct[p] = offset;
+            offset += count;
+        }
+        return distinct;
+    }
+
+    void allocate() {
+        // calloc returns large blocks as fresh zero pages, so the workers fault them in, not the caller.
+        ctrl_ = static_cast<uint8_t*>(std::calloc(capacity_, 1));
+        slots_ = static_cast<value_type*>(std::malloc(capacity_ * sizeof(value_type)));
+        if (!ctrl_ || !slots_) {
+            release();
+            throw std::bad_alloc();
+        }
+    }
+
+    void release() {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            if (ctrl_) {
+                for (size_t i = 0; i < capacity_; ++i) {
+                    if (ctrl_[i]) slots_[i].~value_type();
+                }
+            }
+        }
+        std::free(ctrl_);
+        std::free(slots_);
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = 0;
+        partition_bits_ = 0;
+        partition_shift_ = 0;
+        size_ = 0;
+    }
+
+    /// Inserts or overwrites @p key in its partition. Returns 1 if it was new.
+    size_t place(size_t hash, const Key& key, const Value& value) {
+        const size_t base = partition_of(hash) << partition_shift_;
+        const size_t mask = (size_t{1} << partition_shift_) - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            if (!ctrl_[base + i]) {
+                ctrl_[base + i] = 1;
+                ::new (&slots_[base + i]) value_type(key, value);
+                return 1;
+            }
+            if (equal_(slots_[base + i].first, key)) {
+                slots_[base + i].second = value;
+                return 0;
+            }
+        }
+    }
+
+    uint8_t* ctrl_ = nullptr;
+    value_type* slots_ = nullptr;
+    size_t capacity_ = 0;
+    size_t partition_bits_ = 0;
+    size_t partition_shift_ = 0;  ///< log2 of the slots per partition.
+    size_t size_ = 0;
+    Hash hash_;
+    KeyEqual equal_;
+};
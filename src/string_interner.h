@@ -0,0 +1,94 @@
+/**
+ * @file string_interner.h
+ * @brief Dictionary encoding of strings: value -> dense id and id -> value.
+ *
+ * Interned strings are copied once into an append-only arena. The map is
+ * keyed by `std::string_view`s into that arena, so map entries stay small and
+ * never own heap strings, and the reverse vector hands out the same views.
+ *
+ *     StringInterner<absl::flat_hash_map<std::string_view, uint32_t>> dict;
+ *     uint32_t id = dict.intern("foo");   // 0
+ *     std::string_view s = dict.value(id); // "foo"
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "memory_usage.h"
+
+/**
+ * @brief Append-only storage for string bytes, allocated in 64 KiB blocks.
+ *
+ * Views returned by copy() stay valid for the arena's lifetime.
+ */
+class StringArena {
+public:
+    std::string_view copy(std::string_view s) {
+        if (s.size() > remaining_) grow(s.size());
+        char* dst = cursor_;
+        std::memcpy(dst, s.data(), s.size());
+        cursor_ += s.size();
+        remaining_ -= s.size();
+        return {dst, s.size()};
+    }
+
+    /// Bytes of all blocks allocated so far.
+    size_t allocated_bytes() const { return allocated_; }
+
+private:
+    static constexpr size_t kBlockSize = size_t{64} << 10;
+
+    void grow(size_t min_size) {
+        const size_t size = std::max(kBlockSize, min_size);
+        blocks_.push_back(std::make_unique<char[]>(size));
+        cursor_ = blocks_.back().get();
+        remaining_ = size;
+        allocated_ += size;
+    }
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* cursor_ = nullptr;
+    size_t remaining_ = 0;
+    size_t allocated_ = 0;
+};
+
+/**
+ * @brief Assigns dense ids (0, 1, 2, ...) to distinct strings in order of first appearance.
+ * @tparam IndexMap Map from std::string_view to uint32_t (any contender).
+ */
+template<typename IndexMap>
+class StringInterner {
+public:
+    /**
+     * @brief Id of @p s, interning it if it was not seen before.
+     */
+    uint32_t intern(std::string_view s) {
+        auto it = index_.find(s);
+        if (it != index_.end()) return it->second;
+        const std::string_view stored = arena_.copy(s);
+        const uint32_t id = static_cast<uint32_t>(values_.size());
+        values_.push_back(stored);
+        index_[stored] = id;
+        return id;
+    }
+
+    /// The string with id @p id.
+    std::string_view value(uint32_t id) const { return values_[id]; }
+
+    size_t size() const { return values_.size(); }
+    /// Approximate heap bytes, used when allocator statistics are unavailable.
+    size_t allocated_bytes() const {
+        return arena_.allocated_bytes() + values_.capacity() * sizeof(std::string_view) + ApproxTableBytes(index_);
+    }
+
+private:
+    StringArena arena_;
+    std::vector<std::string_view> values_;  ///< id -> string, pointing into arena_.
+    IndexMap index_;                        ///< string -> id, keys point into arena_.
+};
@@ -0,0 +1,141 @@
+/**
+ * @file string_interning_benchmarks.cpp
+ * @brief Dictionary-encoding a string column with each contender.
+ *
+ * The input is a column of N strings stored contiguously with offsets (as a
+ * columnar format would hand it over). Encoding maps every value to a dense
+ * id with StringInterner (string_interner.h): `string_view` keys into an
+ * arena plus a reverse id -> string vector.
+ *
+ * Columns are generated with:
+ * - `distinct` values whose frequencies follow Zipf(1.0), as real
+ *   categorical data does.
+ * - `lengths` 0 (short, median 8 bytes: codes, names) or 1 (long, median
+ *   48 bytes: URLs, paths), log-normally distributed.
+ *
+ * Reports values/sec (items_per_second), input bytes/sec, and the dictionary
+ * footprint (`bytes`, `bytes_per_distinct`) including the arena.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <unordered_map>
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "robin_hood.h"
+#include "parallel_hashmap/phmap.h"
+#include "sparse_hash_map.h"
+#include "string_interner.h"
+#include "benchmark_data.h"
+#include "memory_usage.h"
+
+/**
+ * @brief A string column: all bytes back to back, value i is [offsets[i], offsets[i + 1]).
+ */
+struct StringColumn {
+    std::string data;
+    std::vector<uint32_t> offsets{0};
+
+    size_t size() const { return offsets.size() - 1; }
+    std::string_view at(size_t i) const { return {data.data() + offsets[i], offsets[i + 1] - offsets[i]}; }
+
+    void push_back(std::string_view s) {
+        data.append(s);
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+    }
+};
+
+/**
+ * @brief @p count distinct random alphanumeric strings with log-normal lengths.
+ * @param profile 0 = short (median 8, 2..32 bytes), 1 = long (median 48, 16..256 bytes).
+ */
+static std::vector<std::string> GenerateDictionary(size_t count, int profile) {
+    static constexpr char kChars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-./";
+    const double median = profile == 0 ? 8.0 : 48.0;
+    const size_t min_length = profile == 0 ? 2 : 16;
+    const size_t max_length = profile == 0 ? 32 : 256;
+
+    std::mt19937 gen(42);
+    std::lognormal_distribution<double> length_dis(std::log(median), 0.5);
+    std::uniform_int_distribution<size_t> char_dis(0, sizeof(kChars) - 2);
+
+    std::vector<std::string> dictionary;
+    dictionary.reserve(count);
+    absl::flat_hash_set<std::string> seen;
+    while (dictionary.size() < count) {
+        const size_t length = std::clamp(static_cast<size_t>(length_dis(gen)), min_length, max_length);
+        std::string s(length, ' ');
+        for (char& c : s) c = kChars[char_dis(gen)];
+        if (seen.insert(s).second) dictionary.push_back(std::move(s));
+    }
+    return dictionary;
+}
+
+/**
+ * @brief Column of range(0) values over range(1) distinct strings of length profile range(2).
+ */
+static StringColumn MakeColumn(const benchmark::State& state) {
+    const std::vector<std::string> dictionary = GenerateDictionary(state.range(1), static_cast<int>(state.range(2)));
+    ZipfGenerator zipf(dictionary.size(), 1.0, 42);
+
+    StringColumn column;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        column.push_back(dictionary[zipf()]);
+    }
+    return column;
+}
+
+/**
+ * @brief Encodes the whole column into a fresh dictionary each iteration.
+ * Arguments: range(0) = rows, range(1) = distinct values, range(2) = length profile.
+ */
+template<typename IndexMap>
+static void BM_StringInterning(benchmark::State& state) {
+    const StringColumn column = MakeColumn(state);
+    std::vector<uint32_t> codes(column.size());
+
+    for (auto _ : state) {
+        StringInterner<IndexMap> dict;
+        for (size_t i = 0; i < column.size(); ++i) {
+            codes[i] = dict.intern(column.at(i));
+        }
+        benchmark::DoNotOptimize(codes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * column.size());
+    state.SetBytesProcessed(state.iterations() * column.data.size());
+
+    StringInterner<IndexMap> dict;
+    const size_t bytes = BuildAndMeasure(dict, [&] {
+        for (size_t i = 0; i < column.size(); ++i) dict.intern(column.at(i));
+    });
+    state.counters["distinct_seen"] = static_cast<double>(dict.size());
+    state.counters["bytes"] = static_cast<double>(bytes);
+    state.counters["bytes_per_distinct"] = static_cast<double>(bytes) / dict.size();
+}
+
+/**
+ * @brief 1M rows; low, medium and high cardinality; short and long strings.
+ */
+static void InterningArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"rows", "distinct", "lengths"});
+    for (int64_t lengths : {0, 1}) {
+        for (int64_t distinct : {int64_t{1} << 8, int64_t{1} << 14, int64_t{1} << 20}) {
+            bench->Args({int64_t{1} << 20, distinct, lengths});
+        }
+    }
+}
+
+// Register benchmarks
+BENCHMARK_TEMPLATE(BM_StringInterning, std::unordered_map<std::string_view, uint32_t>)->Apply(InterningArgs);
+BENCHMARK_TEMPLATE(BM_StringInterning, absl::flat_hash_map<std::string_view, uint32_t>)->Apply(InterningArgs);
+BENCHMARK_TEMPLATE(BM_StringInterning, robin_hood::unordered_map<std::string_view, uint32_t>)->Apply(InterningArgs);
+BENCHMARK_TEMPLATE(BM_StringInterning, phmap::flat_hash_map<std::string_view, uint32_t>)->Apply(InterningArgs);
+BENCHMARK_TEMPLATE(BM_StringInterning, SparseHashMap<std::string_view, uint32_t>)->Apply(InterningArgs);
+
+BENCHMARK_MAIN();